@@ -0,0 +1,26 @@
+#pragma once
+// =============================================================================
+// audio_features.h — Summary features of a mono render (host only)
+// =============================================================================
+// Computed from the Blackman-Harris-windowed power spectrum averaged over
+// 16384-point, 50%-overlapping frames. Thread-safe (one shared const Fft).
+// =============================================================================
+
+#include <vector>
+
+struct AudioFeatures {
+    double rms;           // linear, whole buffer
+    double peak;          // max |sample|
+    double centroid_hz;   // spectral centroid
+    double alias_db;      // inharmonic / harmonic energy, dB (see below)
+};
+
+// fundamental_hz is the note that was held. Every component the voice can
+// legitimately produce — saw, the sub an octave down, and the harmonics the
+// filter, folder and overdrive add — sits on multiples of fundamental_hz / 2.
+// Energy off that grid is aliasing (plus transient smear), so alias_db is
+// 10·log10(off-grid / on-grid). Note-on/off clicks are broadband and count
+// as off-grid too, so hold the note past the end of the buffer. Pass 0 to
+// skip it (alias_db = 0).
+AudioFeatures ComputeFeatures(const std::vector<float>& x, float sample_rate,
+                              float fundamental_hz);
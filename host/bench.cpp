@@ -0,0 +1,563 @@
+// host/bench.cpp — DSP microbenchmarks with a stored JSON baseline
+// Build:  make -C host bench
+// Usage:  host/build/bench [--json out.json] [--baseline file] [--threshold 0.20]
+//                          [--m7-factor 3.0] [--quick]
+//
+// Measures ns and TSC cycles per unit (sample, op or frame) for the filter,
+// the voice at several parameter settings (per-sample reference path and
+// the specialised block kernels SynthEngine uses), the FX chain, voice-allocator
+// note storms, the eye renderer, the spectrum and scope views, one MIDI CC,
+// the full engine and the compute done at boot. With --baseline, each result is compared to the
+// stored one and anything slower by more than the threshold is flagged;
+// the exit status is 1 if any regressed.
+//
+// The "max voices" figure scales host cycles/sample by --m7-factor (host
+// cycles → Cortex-M7 cycles; the M7 is dual-issue in-order with no vector
+// FPU and slower libm, ~3x is a reasonable starting point until measured
+// on hardware) and fits voices into 80% of 480 MHz / 48 kHz = 10000
+// cycles per sample after the FX chain's share.
+//
+//   make -C host bench-check      compare against host/bench_baseline.json
+//   make -C host bench-baseline   overwrite the baseline with this machine
+
+#include "bench_timer.h"
+#include "ms20_filter.h"
+#include "voice.h"
+#include "voice_allocator.h"
+#include "fx_chain.h"
+#include "eye_renderer.h"
+#include "spectrum.h"
+#include "offline_render.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static constexpr float SR    = 48000.0f;
+static constexpr int   BLOCK = 48;
+
+static constexpr double M7_HZ          = 480e6;
+static constexpr double M7_USABLE      = 0.8;
+static constexpr double M7_BUDGET      = M7_HZ / 48000.0;  // cycles per sample
+static constexpr double FALLBACK_GHZ   = 3.0;              // when no TSC
+static constexpr double FRAME_S        = 0.05;             // display frame budget
+static constexpr double MIDI_MSGS_S    = 31250.0 / 30.0;   // DIN MIDI flat out, 3-byte CCs
+
+struct Result {
+    std::string name;
+    std::string unit;
+    double ns;
+    double cycles;
+};
+
+static int g_iters_scale = 1;
+
+// Per-sample input: deterministic noise at -12 dBFS
+static float g_noise[BLOCK];
+static void FillNoise() {
+    uint32_t s = 7;
+    for (float& x : g_noise) {
+        s = s * 1664525u + 1013904223u;
+        x = static_cast<float>(static_cast<int32_t>(s)) * (0.25f / 2147483648.0f);
+    }
+}
+
+template <typename Fn>
+static Result Run(const char* name, const char* unit, int per_call, int iters, Fn&& fn) {
+    BenchSample s = BenchMin(fn, iters / g_iters_scale);
+    double cycles = s.cycles > 0.0 ? s.cycles : s.ns * FALLBACK_GHZ;
+    Result r{name, unit, s.ns / per_call, cycles / per_call};
+    std::printf("  %-24s %9.2f ns/%-6s %9.1f cycles/%s\n",
+                r.name.c_str(), r.ns, unit, r.cycles, unit);
+    return r;
+}
+
+// --- Benchmarks ---
+
+// accurate: Newton-Raphson loop (CC 11); prints its iterations per tick
+static Result BenchFilter(const char* name, float res, bool accurate = false) {
+    Korg35LPF f;
+    f.Init(SR);
+    f.SetCutoff(1200.0f);
+    f.SetResonance(res);
+    f.SetAccurate(accurate);
+    Result r = Run(name, "sample", BLOCK, 20000, [&] {
+        float acc = 0.0f;
+        for (int i = 0; i < BLOCK; i++) acc += f.Process(g_noise[i]);
+        DoNotOptimize(acc);
+    });
+    if (accurate) {
+        Korg35LPF::NewtonStats st;
+        f.TakeNewtonStats(st);
+        std::printf("  %-24s %9.2f iterations/tick, %u of %u capped\n", "",
+                    st.Average(), st.capped, st.solves);
+    }
+    return r;
+}
+
+static Params VoiceParams(float fold, float res, float filt_env, float sub) {
+    Params p;
+    p.cc_fold = fold;
+    p.cc_res = res;
+    p.cc_filt_env = filt_env;
+    p.cc_sub = sub;
+    p.cc_amp_env = 0.0f;  // organ sustain: the voice stays active throughout
+    p.cc_cutoff = 0.6f;
+    p.Update();
+    return p;
+}
+
+// Per-sample reference path (Voice::Process)
+static Result BenchVoice(const char* name, bool gate, float fold, float res,
+                         float filt_env, float sub) {
+    Params p = VoiceParams(fold, res, filt_env, sub);
+    Voice v;
+    v.Init(SR);
+    if (gate) v.NoteOn(45, 100);
+    return Run(name, "sample", BLOCK, 20000, [&] {
+        float acc = 0.0f;
+        for (int i = 0; i < BLOCK; i++) acc += v.Process(p);
+        DoNotOptimize(acc);
+    });
+}
+
+// Specialised block kernel (Voice::ProcessBlock), what SynthEngine runs
+static Result BenchKernel(const char* name, float fold, float res,
+                          float filt_env, float sub, bool filter_nr = false) {
+    Params p = VoiceParams(fold, res, filt_env, sub);
+    p.cc_filter_nr = filter_nr ? 1.0f : 0.0f;
+    p.Update();
+    Voice v;
+    v.Init(SR);
+    v.NoteOn(45, 100);
+    float buf[BLOCK];
+    return Run(name, "sample", BLOCK, 20000, [&] {
+        for (int i = 0; i < BLOCK; i++) buf[i] = 0.0f;
+        v.ProcessBlock(p, buf, BLOCK);
+        DoNotOptimize(buf[0]);
+    });
+}
+
+// Block kernel with a unison stack of count saws (CC 12) at the default detune
+static Result BenchUnison(const char* name, int count) {
+    Params p = VoiceParams(0.0f, 0.0f, 0.0f, 0.3f);
+    p.cc_unison = (count - 1) / 7.0f;
+    p.Update();
+    Voice v;
+    v.Init(SR);
+    v.NoteOn(45, 100);
+    float buf[BLOCK];
+    return Run(name, "sample", BLOCK, 20000, [&] {
+        for (int i = 0; i < BLOCK; i++) buf[i] = 0.0f;
+        v.ProcessBlock(p, buf, BLOCK);
+        DoNotOptimize(buf[0]);
+    });
+}
+
+static float g_fx_arena_mem[128 * 1024];
+static float g_fx_scratch_mem[FxChain::SCRATCH_FLOATS];
+static ScratchArena g_fx_scratch;
+
+static Result BenchFxDrive(const char* name, float drive, bool cab_ir = false) {
+    static FxChain fx;
+    Arena arena;
+    arena.Init(g_fx_arena_mem, sizeof(g_fx_arena_mem) / sizeof(float));
+    g_fx_scratch.Init(g_fx_scratch_mem, FxChain::SCRATCH_FLOATS);
+    fx.Init(SR, arena, g_fx_scratch);
+    float buf[BLOCK];
+    return Run(name, "sample", BLOCK, 20000, [&] {
+        std::memcpy(buf, g_noise, sizeof(buf));
+        fx.ProcessBlock(buf, BLOCK, drive, cab_ir);
+        DoNotOptimize(buf[0]);
+    });
+}
+
+static Result BenchFxSpace(const char* name, float mix, int decimation = FX_DECIMATION) {
+    static FxChain fx;
+    Arena arena;
+    arena.Init(g_fx_arena_mem, sizeof(g_fx_arena_mem) / sizeof(float));
+    g_fx_scratch.Init(g_fx_scratch_mem, FxChain::SCRATCH_FLOATS);
+    fx.Init(SR, arena, g_fx_scratch, decimation);
+    float buf[BLOCK];
+    return Run(name, "sample", BLOCK, 20000, [&] {
+        std::memcpy(buf, g_noise, sizeof(buf));
+        fx.ProcessSpace(buf, BLOCK, mix);
+        DoNotOptimize(buf[0]);
+    });
+}
+
+// Partitioned convolution: cost per sample against partition size and IR
+// length, one call per partition (as FxChain runs it when B = block)
+template <int B>
+static Result BenchConvolver(int taps) {
+    static Convolver<B> conv;
+    Arena arena;
+    arena.Init(g_fx_arena_mem, sizeof(g_fx_arena_mem) / sizeof(float));
+    conv.Init(arena, taps);
+    std::vector<float> ir(taps);
+    for (int i = 0; i < taps; i++) ir[i] = g_noise[i % BLOCK] * std::exp(-4.0f * i / taps);
+    conv.SetIR(ir.data(), taps);
+    std::string name = "conv_b" + std::to_string(B) + "_" + std::to_string(taps);
+    float buf[B];
+    for (int i = 0; i < B; i++) buf[i] = g_noise[i % BLOCK];
+    return Run(name.c_str(), "sample", B, 2000000 / (B + taps / 8), [&] {
+        conv.Process(buf, B);
+        DoNotOptimize(buf[0]);
+    });
+}
+
+template <int B>
+static void BenchConvolverSizes(std::vector<Result>& rs) {
+    for (int taps : {512, 2048, 4096}) rs.push_back(BenchConvolver<B>(taps));
+}
+
+static Result BenchAllocator() {
+    // Chords, repeats and steals: 256 pseudo-random on/off ops per call
+    static constexpr int OPS = 256;
+    int notes[OPS];
+    bool on[OPS];
+    uint32_t s = 99;
+    for (int i = 0; i < OPS; i++) {
+        s = s * 1664525u + 1013904223u;
+        notes[i] = 36 + (s >> 24) % 24;
+        on[i] = (s >> 8) & 3;  // 3:1 on vs off keeps all slots busy
+    }
+    VoiceAllocator<4> alloc;
+    alloc.Init();
+    return Run("allocator_note_storm", "op", OPS, 20000, [&] {
+        int acc = 0;
+        for (int i = 0; i < OPS; i++)
+            acc += on[i] ? alloc.NoteOn(notes[i]) : alloc.NoteOff(notes[i]);
+        DoNotOptimize(acc);
+    });
+}
+
+static Result BenchEye() {
+    Params p;
+    p.cc_fx = 0.5f;  // ripple on
+    p.Update();
+    // Frame content varies with the animation, so every call renders the
+    // same frame from a snapshot taken once the rays have grown in
+    EyeRenderer snapshot;
+    snapshot.Init();
+    snapshot.NoteOn();
+    for (int i = 0; i < 40; i++) snapshot.Advance(p, 0.05f);
+    EyeRenderer eye;
+    return Run("eye_render", "frame", 1, 2000, [&] {
+        eye = snapshot;
+        eye.Advance(p, 0.05f);
+        eye.Render();
+        DoNotOptimize(eye.Buffer()[0]);
+    });
+}
+
+// Output views (spectrum.h): a note's worth of the capture ring, analyzed
+// or traced and drawn, as PrepareFrame does in main.cpp
+static void FillCapture(float* x) {
+    for (int i = 0; i < Spectrum::FFT_SIZE; i++)
+        x[i] = 0.5f * std::sin(6.2832f * 220.0f * i / 24000.0f) + g_noise[i % BLOCK];
+}
+
+static Result BenchSpectrum() {
+    static Spectrum spectrum;
+    static float x[Spectrum::FFT_SIZE];
+    spectrum.Init(24000.0f);
+    FillCapture(x);
+    EyeRenderer eye;
+    eye.Init();
+    int marker = spectrum.BarForHz(1000.0f);
+    return Run("spectrum_frame", "frame", 1, 2000, [&] {
+        eye.RenderSpectrum(spectrum.Analyze(x), Spectrum::NUM_BARS, marker);
+        DoNotOptimize(eye.Buffer()[0]);
+    });
+}
+
+static Result BenchScope() {
+    static float x[Spectrum::FFT_SIZE];
+    FillCapture(x);
+    EyeRenderer eye;
+    eye.Init();
+    return Run("scope_frame", "frame", 1, 2000, [&] {
+        eye.RenderScope(Spectrum::Trace(x), Spectrum::SCOPE_W);
+        DoNotOptimize(eye.Buffer()[0]);
+    });
+}
+
+// One incoming CC through the engine, the main loop's per-message MIDI work
+static Result BenchMidiCc() {
+    static OfflineSynth synth;
+    synth.Init(SR);
+    static constexpr int OPS = 128;
+    return Run("midi_cc", "op", OPS, 20000, [&] {
+        for (int i = 0; i < OPS; i++) synth.engine.ControlChange(1 + i % 9, i);
+        DoNotOptimize(synth.engine.GetParams().cc_cutoff);
+    });
+}
+
+// Full engine at a given rate and callback size. Per-sample cost against
+// block size shows the fixed per-block overhead small blocks pay. stereo
+// renders the way the callback does, the right channel as the mirror.
+static Result BenchEngine(const char* name, float sr, int block, bool mod = false,
+                          bool stereo = false) {
+    static OfflineSynth synth;
+    synth.Init(sr);
+    SynthEngine& e = synth.engine;
+    e.ControlChange(CC_AMP_ENV, 0);
+    e.ControlChange(CC_RES, 90);
+    e.ControlChange(CC_FOLD, 40);
+    e.ControlChange(CC_FX, 64);
+    e.ControlChange(CC_FX_MIX, 100);
+    if (mod) {
+        // Every route at three-quarter depth: the cost of the mod engine
+        for (const ModRoute& r : MOD_ROUTES) e.ControlChange(r.cc, 112);
+        e.ControlChange(CC_MOD_ENV_DECAY, 127);
+    }
+    for (int n : {45, 52, 57, 60}) e.NoteOn(n, 100);
+    static float buf[256], right[256];
+    return Run(name, "sample", block, 5000 * BLOCK / block, [&] {
+        e.Process(buf, block, stereo ? right : nullptr);
+        DoNotOptimize(buf[0]);
+    });
+}
+
+// Boot work: what main() does before the first note can play (the
+// engine's Init: arena, voices, FX lines, the cabinet IR and its
+// partition spectra), and the output-view stage deferred to the loop
+static Result BenchBootEngine() {
+    static std::vector<float> mem(OfflineSynth::ARENA_FLOATS);
+    static SynthEngine e;
+    return Run("boot_engine_init", "op", 1, 200, [&] {
+        Arena a;
+        a.Init(mem.data(), mem.size());
+        bool ok = e.Init(SR, a);
+        DoNotOptimize(ok);
+    });
+}
+
+static Result BenchBootViews() {
+    static Spectrum s;
+    return Run("boot_views_init", "op", 1, 2000, [&] {
+        s.Init(SR / 2);
+        DoNotOptimize(s);
+    });
+}
+
+// The engine after its last note: overdrive and reverb on, every voice
+// released and rendered until the voices and FX have gone to sleep
+static Result BenchEngineIdle() {
+    static OfflineSynth synth;
+    synth.Init(SR);
+    SynthEngine& e = synth.engine;
+    e.ControlChange(CC_FX, 64);
+    e.ControlChange(CC_FX_MIX, 100);
+    static float buf[BLOCK];
+    for (int n : {45, 52, 57, 60}) e.NoteOn(n, 100);
+    for (int b = 0; b < 100; b++) e.Process(buf, BLOCK);
+    for (int n : {45, 52, 57, 60}) e.NoteOff(n);
+    for (int b = 0; b < 20 * 1000 && (e.AnyActive() || e.FxAwake()); b++) e.Process(buf, BLOCK);
+    if (e.AnyActive() || e.FxAwake()) std::printf("  engine_idle: still awake after 20 s\n");
+    return Run("engine_idle", "sample", BLOCK, 5000, [&] {
+        e.Process(buf, BLOCK);
+        DoNotOptimize(buf[0]);
+    });
+}
+
+// --- JSON I/O (one result per line, so the reader can stay trivial) ---
+
+static void WriteJson(const std::string& path, const std::vector<Result>& rs,
+                      double m7_factor, int max_voices) {
+    std::ofstream f(path);
+    f << "{\n  \"m7_factor\": " << m7_factor << ",\n"
+      << "  \"max_voices_48k_m7\": " << max_voices << ",\n"
+      << "  \"results\": [\n";
+    for (size_t i = 0; i < rs.size(); i++) {
+        char line[256];
+        std::snprintf(line, sizeof(line),
+                      "    {\"name\": \"%s\", \"unit\": \"%s\", \"ns\": %.3f, \"cycles\": %.2f}%s\n",
+                      rs[i].name.c_str(), rs[i].unit.c_str(), rs[i].ns, rs[i].cycles,
+                      i + 1 < rs.size() ? "," : "");
+        f << line;
+    }
+    f << "  ]\n}\n";
+}
+
+static bool ReadBaseline(const std::string& path, std::map<std::string, double>& ns_by_name) {
+    std::ifstream f(path);
+    if (!f) return false;
+    std::string line;
+    while (std::getline(f, line)) {
+        size_t n = line.find("\"name\": \"");
+        size_t v = line.find("\"ns\": ");
+        if (n == std::string::npos || v == std::string::npos) continue;
+        n += 9;
+        std::string name = line.substr(n, line.find('"', n) - n);
+        ns_by_name[name] = std::atof(line.c_str() + v + 6);
+    }
+    return true;
+}
+
+static const Result* Find(const std::vector<Result>& rs, const char* name) {
+    for (const Result& r : rs)
+        if (r.name == name) return &r;
+    return nullptr;
+}
+
+int main(int argc, char** argv) {
+    std::string json_path, baseline_path;
+    double threshold = 0.20;
+    double m7_factor = 3.0;
+    for (int i = 1; i < argc; i++) {
+        bool has_val = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--json") && has_val)            json_path = argv[++i];
+        else if (!std::strcmp(argv[i], "--baseline") && has_val)   baseline_path = argv[++i];
+        else if (!std::strcmp(argv[i], "--threshold") && has_val)  threshold = std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "--m7-factor") && has_val)  m7_factor = std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "--quick"))                 g_iters_scale = 10;
+        else {
+            std::fprintf(stderr, "usage: bench [--json f] [--baseline f] [--threshold x] "
+                                 "[--m7-factor x] [--quick]\n");
+            return 2;
+        }
+    }
+
+    EnableFlushToZero();   // as on the Seed (denormals.h)
+    FillNoise();
+    std::vector<Result> rs;
+
+    std::printf("filter\n");
+    rs.push_back(BenchFilter("korg35_res_low", 0.1f));
+    rs.push_back(BenchFilter("korg35_res_high", 0.95f));
+    rs.push_back(BenchFilter("korg35_nr_res_low", 0.1f, true));
+    rs.push_back(BenchFilter("korg35_nr_res_high", 0.95f, true));
+
+    std::printf("voice\n");
+    rs.push_back(BenchVoice("voice_env_idle",     false, 0.0f, 0.0f, 0.0f, 0.3f));
+    rs.push_back(BenchVoice("voice_plain",        true,  0.0f, 0.0f, 0.0f, 0.3f));
+    rs.push_back(BenchVoice("voice_fold",         true,  0.8f, 0.0f, 0.0f, 0.3f));
+    rs.push_back(BenchVoice("voice_res_high",     true,  0.0f, 1.0f, 0.0f, 0.3f));
+    rs.push_back(BenchVoice("voice_fold_res_high",true,  0.8f, 1.0f, 0.0f, 0.3f));
+    rs.push_back(BenchVoice("voice_filt_env",     true,  0.0f, 0.3f, 1.0f, 0.3f));
+    rs.push_back(BenchVoice("voice_no_sub",       true,  0.0f, 0.0f, 0.0f, 0.0f));
+
+    std::printf("voice kernels (block)\n");
+    rs.push_back(BenchKernel("kernel_plain",         0.0f, 0.0f, 0.0f, 0.3f));
+    rs.push_back(BenchKernel("kernel_fold",          0.8f, 0.0f, 0.0f, 0.3f));
+    rs.push_back(BenchKernel("kernel_res_high",      0.0f, 1.0f, 0.0f, 0.3f));
+    rs.push_back(BenchKernel("kernel_fold_res_high", 0.8f, 1.0f, 0.0f, 0.3f));
+    rs.push_back(BenchKernel("kernel_filt_env",      0.0f, 0.3f, 1.0f, 0.3f));
+    rs.push_back(BenchKernel("kernel_no_sub",        0.0f, 0.0f, 0.0f, 0.0f));
+    rs.push_back(BenchKernel("kernel_all_features",  0.8f, 1.0f, 1.0f, 0.3f));
+    rs.push_back(BenchKernel("kernel_res_high_nr",   0.0f, 1.0f, 0.0f, 0.3f, true));
+
+    // Not kernel_*: the max-voices figure below is for the default patch
+    std::printf("unison (block kernel, plain)\n");
+    rs.push_back(BenchUnison("unison_2", 2));
+    rs.push_back(BenchUnison("unison_4", 4));
+    rs.push_back(BenchUnison("unison_8", 8));
+
+    std::printf("fx\n");
+    rs.push_back(BenchFxDrive("fx_drive_0", 0.0f));
+    rs.push_back(BenchFxDrive("fx_drive_0.5", 0.5f));
+    rs.push_back(BenchFxDrive("fx_drive_1", 1.0f));
+    rs.push_back(BenchFxDrive("fx_drive_1_cab_ir", 1.0f, true));
+    rs.push_back(BenchFxSpace("fx_space_dry", 0.0f));
+    rs.push_back(BenchFxSpace("fx_space_chorus", 0.5f));
+    rs.push_back(BenchFxSpace("fx_space_reverb", 1.0f));
+    rs.push_back(BenchFxSpace("fx_space_chorus_r1", 0.5f, 1));
+    rs.push_back(BenchFxSpace("fx_space_chorus_r4", 0.5f, 4));
+    rs.push_back(BenchFxSpace("fx_space_reverb_r1", 1.0f, 1));
+    rs.push_back(BenchFxSpace("fx_space_reverb_r4", 1.0f, 4));
+
+    std::printf("cabinet convolution (partition × IR taps)\n");
+    BenchConvolverSizes<16>(rs);
+    BenchConvolverSizes<32>(rs);
+    BenchConvolverSizes<48>(rs);
+    BenchConvolverSizes<64>(rs);
+    BenchConvolverSizes<128>(rs);
+
+    std::printf("control / display\n");
+    rs.push_back(BenchAllocator());
+    rs.push_back(BenchEye());
+    rs.push_back(BenchSpectrum());
+    rs.push_back(BenchScope());
+    rs.push_back(BenchMidiCc());
+
+    std::printf("engine\n");
+    rs.push_back(BenchEngine("engine_4voice_full_fx", SR, BLOCK));
+    rs.push_back(BenchEngine("engine_block8", SR, 8));
+    rs.push_back(BenchEngine("engine_block256", SR, 256));
+    rs.push_back(BenchEngine("engine_96k", 96000.0f, BLOCK));
+    rs.push_back(BenchEngine("engine_mod_all_routes", SR, BLOCK, true));
+    rs.push_back(BenchEngine("engine_stereo_out", SR, BLOCK, false, true));
+    rs.push_back(BenchEngineIdle());
+
+    std::printf("boot\n");
+    rs.push_back(BenchBootEngine());
+    rs.push_back(BenchBootViews());
+
+    // Max voices on the Seed: worst block-kernel config (the engine's path)
+    // vs what's left after FX
+    double voice_host = 0.0;
+    for (const Result& r : rs)
+        if (r.name.rfind("kernel_", 0) == 0) voice_host = std::max(voice_host, r.cycles);
+    double fx_host = Find(rs, "fx_drive_1")->cycles + Find(rs, "fx_space_reverb")->cycles;
+    double voice_m7 = voice_host * m7_factor;
+    double fx_m7 = fx_host * m7_factor;
+    int max_voices = static_cast<int>((M7_BUDGET * M7_USABLE - fx_m7) / voice_m7);
+    std::printf("\nM7 estimate (x%.1f): worst voice %.0f cycles/sample, FX %.0f, "
+                "budget %.0f → max %d voices at 48 kHz\n",
+                m7_factor, voice_m7, fx_m7, M7_BUDGET * M7_USABLE, max_voices);
+
+    // Each saw a unison stack adds: slope from one saw (the plain kernel) to 8
+    double per_saw = (Find(rs, "unison_8")->cycles - Find(rs, "kernel_plain")->cycles) / 7.0;
+    std::printf("M7 unison: %.0f cycles/sample per extra saw (host %.1f), "
+                "8 saws on every voice = %.1f%% of the budget\n",
+                per_saw * m7_factor, per_saw,
+                100.0 * 7.0 * per_saw * m7_factor * SynthEngine::NUM_VOICES / (M7_BUDGET * M7_USABLE));
+
+    // Startup compute on the M7 (the rest of boot is peripherals and I/O)
+    std::printf("M7 boot: engine init %.2f ms before the first note, views %.3f ms after\n",
+                Find(rs, "boot_engine_init")->cycles * m7_factor / M7_HZ * 1000.0,
+                Find(rs, "boot_views_init")->cycles * m7_factor / M7_HZ * 1000.0);
+
+    // Display frame on the main loop: the heavier output view plus a
+    // frame's worth of MIDI at full DIN rate, against the time the audio
+    // callback leaves over in one 50 ms frame
+    double view_m7 = std::max(Find(rs, "spectrum_frame")->cycles,
+                              Find(rs, "scope_frame")->cycles) * m7_factor;
+    double midi_m7 = Find(rs, "midi_cc")->cycles * m7_factor * MIDI_MSGS_S * FRAME_S;
+    double loop_m7 = M7_HZ * FRAME_S * (1.0 - M7_USABLE);
+    std::printf("M7 frame: view %.0f + MIDI %.0f cycles = %.1f%% of the %.0f left "
+                "per %.0f ms frame\n",
+                view_m7, midi_m7, 100.0 * (view_m7 + midi_m7) / loop_m7, loop_m7,
+                FRAME_S * 1000.0);
+
+    if (!json_path.empty()) WriteJson(json_path, rs, m7_factor, max_voices);
+
+    if (baseline_path.empty()) return 0;
+    std::map<std::string, double> base;
+    if (!ReadBaseline(baseline_path, base)) {
+        std::fprintf(stderr, "cannot read baseline %s\n", baseline_path.c_str());
+        return 2;
+    }
+    int regressions = 0;
+    std::printf("\nvs baseline (threshold +%.0f%%)\n", threshold * 100.0);
+    for (const Result& r : rs) {
+        auto it = base.find(r.name);
+        if (it == base.end()) {
+            std::printf("  %-24s new\n", r.name.c_str());
+            continue;
+        }
+        double change = r.ns / it->second - 1.0;
+        bool bad = change > threshold && r.ns - it->second > 1.0;  // ignore sub-ns noise
+        std::printf("  %-24s %+6.1f%%%s\n", r.name.c_str(), change * 100.0,
+                    bad ? "  REGRESSION" : "");
+        regressions += bad;
+    }
+    return regressions ? 1 : 0;
+}
@@ -0,0 +1,50 @@
+#pragma once
+// =============================================================================
+// bench_timer.h — Wall-clock + TSC timing for host benchmarks
+// =============================================================================
+// Cycles are TSC ticks on x86 (constant-rate on modern CPUs, so they track
+// wall time at the nominal clock rather than the boosted core clock) and 0
+// elsewhere; ns is always available.
+// =============================================================================
+
+#include <chrono>
+#include <cstdint>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+inline uint64_t BenchCycles() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+struct BenchSample {
+    double ns;
+    double cycles;
+};
+
+// Run fn() `iters` times, `reps` times over; keep the fastest repetition.
+// Returns cost per call.
+template <typename Fn>
+BenchSample BenchMin(Fn&& fn, int iters, int reps = 9) {
+    BenchSample best{1e300, 1e300};
+    for (int r = 0; r < reps; r++) {
+        auto t0 = std::chrono::steady_clock::now();
+        uint64_t c0 = BenchCycles();
+        for (int i = 0; i < iters; i++) fn();
+        uint64_t c1 = BenchCycles();
+        auto t1 = std::chrono::steady_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / iters;
+        if (ns < best.ns) best = {ns, static_cast<double>(c1 - c0) / iters};
+    }
+    return best;
+}
+
+// Keep the optimizer from discarding a result
+template <typename T>
+inline void DoNotOptimize(T const& v) {
+    asm volatile("" : : "r,m"(v) : "memory");
+}
@@ -0,0 +1,46 @@
+#pragma once
+// =============================================================================
+// file_sink.h — A plain file standing in for the SD card (host only)
+// =============================================================================
+// Recorder's Sink (src/recorder.h) on stdio. write_delay_us stalls every
+// write, to stand in for a slow card or a long SD busy period.
+// =============================================================================
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+class FileSink {
+public:
+    uint32_t write_delay_us = 0;
+
+    bool Open(const std::string& path) {
+        file_ = std::fopen(path.c_str(), "wb");
+        writes_ = 0;
+        return file_ != nullptr;
+    }
+
+    bool Write(const uint8_t* data, uint32_t bytes) {
+        if (write_delay_us) std::this_thread::sleep_for(std::chrono::microseconds(write_delay_us));
+        writes_++;
+        return file_ && std::fwrite(data, 1, bytes, file_) == bytes;
+    }
+
+    bool WriteAt(uint32_t offset, const uint8_t* data, uint32_t bytes) {
+        return file_ && std::fseek(file_, static_cast<long>(offset), SEEK_SET) == 0 &&
+               std::fwrite(data, 1, bytes, file_) == bytes;
+    }
+
+    void Close() {
+        if (file_) std::fclose(file_);
+        file_ = nullptr;
+    }
+
+    uint32_t Writes() const { return writes_; }
+
+private:
+    std::FILE* file_ = nullptr;
+    uint32_t   writes_ = 0;
+};
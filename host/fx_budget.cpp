@@ -0,0 +1,201 @@
+// host/fx_budget.cpp — Per-stage cycle budget for the block FX stages
+// Build:  make -C host fx-budget
+// Run:    host/build/fx-budget
+//
+// Runs the overdrive, Chorus and Reverb on noise in 48-sample blocks at 48 kHz and prints
+// per-block cost (ns and TSC cycles) plus the share of the 1 ms callback
+// period each stage uses on this machine. Also reports how long the reverb
+// tail takes to fall below the FxChain sleep threshold after input stops —
+// the time after which a dry CC 9 costs nothing.
+//
+// The multi-rate section runs FxChain::ProcessSpace with chorus and reverb
+// at 1/1, 1/2 and 1/4 rate (FX_DECIMATION) and prints arena use and cost
+// for each, then the FxResampler round trip on its own: passband ripple,
+// rejection of what would alias at the low rate, and latency.
+
+#include "arena.h"
+#include "chorus.h"
+#include "reverb.h"
+#include "fx_chain.h"
+#include "resampler.h"
+#include "bench_timer.h"
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+
+static constexpr float SR      = 48000.0f;
+static constexpr int   BLOCK   = 48;
+static constexpr int   BLOCKS  = 20000;  // ~20 s of audio per stage
+
+static float arena_mem[128 * 1024];
+static float fx_arena_mem[64 * 1024];
+static float rate_arena_mem[3][64 * 1024];
+static float scratch_mem[FxChain::SCRATCH_FLOATS];
+static ScratchArena scratch;
+
+template <typename Fn>
+static void Measure(const char* name, Fn&& process) {
+    float in[BLOCK], out[BLOCK];
+    uint32_t seed = 1;
+    double block_period_ns = BLOCK / SR * 1e9;
+
+    auto t0 = std::chrono::steady_clock::now();
+    uint64_t c0 = BenchCycles();
+    for (int b = 0; b < BLOCKS; b++) {
+        for (int i = 0; i < BLOCK; i++) {
+            seed = seed * 1664525u + 1013904223u;
+            in[i] = (float)(int32_t)seed * (0.25f / 2147483648.0f);
+        }
+        process(in, out);
+    }
+    uint64_t c1 = BenchCycles();
+    auto t1 = std::chrono::steady_clock::now();
+
+    double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / BLOCKS;
+    double cyc = (double)(c1 - c0) / BLOCKS;
+    std::printf("%-10s %9.0f ns/block %10.0f cycles/block %6.2f%% of block period\n",
+                name, ns, cyc, 100.0 * ns / block_period_ns);
+}
+
+// Gain of the FxResampler round trip for a sine at freq, in dB
+static double RoundTripGain(int factor, double freq) {
+    static FxResampler rs;
+    rs.Init(factor);
+    float in[BLOCK], low[BLOCK], out[BLOCK];
+    double e_in = 0.0, e_out = 0.0;
+    double w = 2.0 * 3.14159265358979 * freq / SR;
+    int settle = 8, blocks = 8 + 200;
+    for (int b = 0; b < blocks; b++) {
+        for (int i = 0; i < BLOCK; i++) in[i] = (float)std::sin(w * (b * BLOCK + i));
+        int m = rs.Down(in, BLOCK, low);
+        rs.Up(low, m, out, BLOCK);
+        if (b < settle) continue;
+        for (int i = 0; i < BLOCK; i++) {
+            e_in += (double)in[i] * in[i];
+            e_out += (double)out[i] * out[i];
+        }
+    }
+    return 10.0 * std::log10(e_out / e_in + 1e-30);
+}
+
+// Position of the largest output sample for an impulse at sample 0
+static int RoundTripPeak(int factor) {
+    static FxResampler rs;
+    rs.Init(factor);
+    float in[BLOCK], low[BLOCK], out[BLOCK];
+    int peak_at = 0;
+    float peak = 0.0f;
+    for (int b = 0; b < 8; b++) {
+        for (int i = 0; i < BLOCK; i++) in[i] = (b == 0 && i == 0) ? 1.0f : 0.0f;
+        int m = rs.Down(in, BLOCK, low);
+        rs.Up(low, m, out, BLOCK);
+        for (int i = 0; i < BLOCK; i++) {
+            if (std::fabs(out[i]) > peak) {
+                peak = std::fabs(out[i]);
+                peak_at = b * BLOCK + i;
+            }
+        }
+    }
+    return peak_at;
+}
+
+static void MultiRate() {
+    std::printf("\nmulti-rate chorus/reverb (FxChain::ProcessSpace, %d-sample blocks)\n", BLOCK);
+    static FxChain fx[3];
+    const int factors[3] = {1, 2, 4};
+    for (int k = 0; k < 3; k++) {
+        int r = factors[k];
+        Arena a;
+        a.Init(rate_arena_mem[k], sizeof(rate_arena_mem[k]) / sizeof(rate_arena_mem[k][0]));
+        // Chorus and reverb are allocated first; measure them on their own
+        Arena probe;
+        probe.Init(rate_arena_mem[k], sizeof(rate_arena_mem[k]) / sizeof(rate_arena_mem[k][0]));
+        Chorus c;
+        Reverb v;
+        c.Init(SR / r, probe);
+        v.Init(SR / r, probe);
+        size_t space_floats = probe.Used();
+        fx[k].Init(SR, a, scratch, r);
+        std::printf("\n1/%d rate: chorus + reverb lines %zu floats (%.1f KB)\n",
+                    r, space_floats, space_floats * 4.0 / 1024.0);
+
+        char name[32];
+        std::snprintf(name, sizeof(name), "chorus /%d", r);
+        Measure(name, [&](const float* in, float* out) {
+            for (int i = 0; i < BLOCK; i++) out[i] = in[i];
+            fx[k].ProcessSpace(out, BLOCK, 0.5f);
+        });
+        std::snprintf(name, sizeof(name), "reverb /%d", r);
+        Measure(name, [&](const float* in, float* out) {
+            for (int i = 0; i < BLOCK; i++) out[i] = in[i];
+            fx[k].ProcessSpace(out, BLOCK, 1.0f);
+        });
+    }
+
+    std::printf("\nFxResampler round trip (Down → Up), %.0f Hz\n", SR);
+    std::printf("factor  passband      ripple dB  alias band        rejection dB  latency (peak)\n");
+    const int round_trips[2] = {2, 4};
+    for (int r : round_trips) {
+        double pass_edge = 0.2 * SR / (r / 2);
+        double stop_edge = 0.3 * SR / (r / 2);
+        double ripple = 0.0, reject = -200.0;
+        for (double f = 50.0; f <= pass_edge; f += 50.0)
+            ripple = std::fmax(ripple, std::fabs(RoundTripGain(r, f)));
+        for (double f = stop_edge; f < 0.5 * SR; f += 100.0)
+            reject = std::fmax(reject, RoundTripGain(r, f));
+        FxResampler rs;
+        rs.Init(r);
+        std::printf("  %d     0–%5.0f Hz  %9.4f  %5.0f–%5.0f Hz  %12.1f  %d (%d)\n",
+                    r, pass_edge, ripple, stop_edge, 0.5 * SR, reject,
+                    rs.Latency(), RoundTripPeak(r));
+    }
+}
+
+int main() {
+    scratch.Init(scratch_mem, FxChain::SCRATCH_FLOATS);
+    Arena arena;
+    arena.Init(arena_mem, sizeof(arena_mem) / sizeof(arena_mem[0]));
+
+    Chorus chorus;
+    Reverb reverb;
+    if (!chorus.Init(SR, arena) || !reverb.Init(SR, arena)) {
+        std::printf("arena too small\n");
+        return 1;
+    }
+    std::printf("arena: %zu floats (%.1f KB) for chorus + reverb @ %.0f Hz\n",
+                arena.Used(), arena.Used() * 4.0 / 1024.0, SR);
+    std::printf("(test-signal generation included in every row)\n\n");
+
+    FxChain fx;
+    Arena fx_arena;
+    fx_arena.Init(fx_arena_mem, sizeof(fx_arena_mem) / sizeof(fx_arena_mem[0]));
+    fx.Init(SR, fx_arena, scratch);
+
+    Measure("asleep", [](const float*, float*) {});
+    Measure("drive 0", [&](const float* in, float* out) {
+        for (int i = 0; i < BLOCK; i++) out[i] = in[i];
+        fx.ProcessBlock(out, BLOCK, 0.0f);
+    });
+    Measure("drive 0.5", [&](const float* in, float* out) {
+        for (int i = 0; i < BLOCK; i++) out[i] = in[i];
+        fx.ProcessBlock(out, BLOCK, 0.5f);
+    });
+    Measure("chorus", [&](const float* in, float* out) { chorus.ProcessBlock(in, out, BLOCK); });
+    Measure("reverb", [&](const float* in, float* out) { reverb.ProcessBlock(in, out, BLOCK); });
+
+    // Reverb tail: blocks until the output stays under the sleep threshold
+    float out[BLOCK];
+    int quiet = 0, blocks = 0;
+    while (quiet < 16 && blocks < 48000) {
+        reverb.ProcessBlock(nullptr, out, BLOCK);
+        float peak = 0.0f;
+        for (int i = 0; i < BLOCK; i++) peak = std::fmax(peak, std::fabs(out[i]));
+        quiet = (peak < 1e-4f) ? quiet + 1 : 0;
+        blocks++;
+    }
+    std::printf("\nreverb tail reaches sleep after %.0f ms\n", blocks * BLOCK / SR * 1000.0f);
+
+    MultiRate();
+    return 0;
+}
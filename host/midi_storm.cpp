@@ -0,0 +1,244 @@
+// host/midi_storm.cpp — Worst-case MIDI storm stress harness with a
+// simulated 48-sample callback deadline
+// Build:  make -C host midi-storm
+// Usage:  host/build/midi-storm [--m7-factor 3.0] [--runs 3] [--seconds 2]
+//                               [--only NAME] [--govern]
+//
+// Replays adversarial generated MIDI streams block by block, the way the
+// firmware interleaves them: the main loop handles every event due in a
+// block (ApplyMessage — what HandleMidiEvent does), then the audio callback
+// renders 48 samples (SynthEngine::Process). Both are timed per block with
+// the TSC.
+//
+// The deadline is the Seed's: 480 MHz × 48 / 48 kHz = 480000 cycles per
+// callback. Host cycles are scaled by --m7-factor, as in bench. Per scenario
+// it reports the callback's worst, p99 and mean share of the deadline, the
+// number of blocks that would miss it, and "starve": blocks where event
+// handling + rendering together exceed the block period, i.e. the main loop
+// would fall behind the MIDI input.
+//
+// Every scenario is deterministic, so it is run --runs times and each block
+// keeps its fastest time; that filters OS preemption on the host out of the
+// worst case. Exit status is 1 if any block missed the deadline.
+//
+// --govern closes the loop the way the firmware does: a QualityGovernor is
+// fed each callback's M7-scaled cost and sets the engine's quality for the
+// next block. Quality then depends on timing, so each scenario runs once;
+// the extra columns are the highest level reached, the number of level
+// changes and the share of blocks spent below full quality.
+
+#include "bench_timer.h"
+#include "offline_render.h"
+#include "quality_governor.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+static constexpr float  SR        = 48000.0f;
+static constexpr int    BLOCK     = 48;
+static constexpr double M7_HZ     = 480e6;
+static constexpr double DEADLINE  = M7_HZ * BLOCK / 48000.0;  // M7 cycles per callback
+
+static constexpr uint8_t NOTE_ON  = 0x90 | MIDI_CHANNEL;
+static constexpr uint8_t NOTE_OFF = 0x80 | MIDI_CHANNEL;
+static constexpr uint8_t CC       = 0xB0 | MIDI_CHANNEL;
+static constexpr uint8_t BEND     = 0xE0 | MIDI_CHANNEL;
+
+// Events for block b (time_s is ignored; everything is due in that block)
+using Generator = void (*)(int b, std::vector<MidiMessage>& ev);
+
+static void Msg(std::vector<MidiMessage>& ev, uint8_t st, int d1, int d2) {
+    ev.push_back({0.0, st, (uint8_t)(d1 & 0x7F), (uint8_t)(d2 & 0x7F)});
+}
+
+static const int ALL_CCS[] = {CC_CUTOFF, CC_RES, CC_SUB, CC_FOLD, CC_DECAY,
+                              CC_AMP_ENV, CC_FILT_ENV, CC_FX, CC_FX_MIX};
+
+// Worst-sounding corner: full resonance, fold, sub, drive and wet FX
+static void HotPatch(std::vector<MidiMessage>& ev) {
+    Msg(ev, CC, CC_RES, 127);
+    Msg(ev, CC, CC_FOLD, 127);
+    Msg(ev, CC, CC_SUB, 127);
+    Msg(ev, CC, CC_FX, 127);
+    Msg(ev, CC, CC_FX_MIX, 127);
+    Msg(ev, CC, CC_DECAY, 127);
+}
+
+struct Scenario {
+    const char* name;
+    const char* what;
+    Generator   gen;
+};
+
+static const Scenario SCENARIOS[] = {
+    {"all_notes", "all 128 notes on in one block, all off 100 ms later",
+     [](int b, std::vector<MidiMessage>& ev) {
+         if (b == 0) HotPatch(ev);
+         int phase = b % 200;
+         if (phase == 0)   for (int n = 0; n < 128; n++) Msg(ev, NOTE_ON, n, 127);
+         if (phase == 100) for (int n = 0; n < 128; n++) Msg(ev, NOTE_OFF, n, 0);
+     }},
+    {"cc_every_sample", "one CC per sample (USB rate), cycling all 9 CCs, 4 notes held",
+     [](int b, std::vector<MidiMessage>& ev) {
+         if (b == 0) for (int n = 0; n < 4; n++) Msg(ev, NOTE_ON, 36 + n * 7, 120);
+         for (int i = 0; i < BLOCK; i++) {
+             int k = b * BLOCK + i;
+             Msg(ev, CC, ALL_CCS[k % 9], (k * 37) & 127);
+         }
+     }},
+    {"bend_wiggle", "pitch bend every sample across the full range, chord held",
+     [](int b, std::vector<MidiMessage>& ev) {
+         if (b == 0) {
+             HotPatch(ev);
+             for (int n = 0; n < 4; n++) Msg(ev, NOTE_ON, 48 + n * 4, 110);
+         }
+         for (int i = 0; i < BLOCK; i++) {
+             int v = 8192 + (int)(8191.0 * std::sin((b * BLOCK + i) * 0.01));
+             Msg(ev, BEND, v, v >> 7);
+         }
+     }},
+    {"steal_storm", "a new note every block on 4 voices (constant stealing), hot patch",
+     [](int b, std::vector<MidiMessage>& ev) {
+         if (b == 0) HotPatch(ev);
+         int note = 24 + (b * 7) % 96;
+         Msg(ev, NOTE_ON, note, 1 + (b * 13) % 127);
+         if (b >= 4) Msg(ev, NOTE_OFF, 24 + ((b - 4) * 7) % 96, 0);
+     }},
+    {"release_tails", "chords released into long decays and reverb tails (denormal-prone)",
+     [](int b, std::vector<MidiMessage>& ev) {
+         if (b == 0) {
+             HotPatch(ev);
+             Msg(ev, CC, CC_FX, 0);
+         }
+         int phase = b % 1000;  // 1 s of chord, then release to silence
+         if (phase == 0)  for (int n = 0; n < 4; n++) Msg(ev, NOTE_ON, 40 + n * 5, 100);
+         if (phase == 50) for (int n = 0; n < 4; n++) Msg(ev, NOTE_OFF, 40 + n * 5, 0);
+     }},
+    {"everything", "note storm + CC flood + bend wiggle at once",
+     [](int b, std::vector<MidiMessage>& ev) {
+         if (b == 0) HotPatch(ev);
+         for (int i = 0; i < BLOCK; i++) {
+             int k = b * BLOCK + i;
+             if (i % 2) Msg(ev, CC, ALL_CCS[k % 9], 64 + (int)(63.0 * std::sin(k * 0.003)));
+             else       Msg(ev, BEND, (k * 97) & 0x3FFF, ((k * 97) & 0x3FFF) >> 7);
+         }
+         for (int n = 0; n < 8; n++) Msg(ev, NOTE_ON, (b * 11 + n * 5) & 127, 127);
+         for (int n = 0; n < 8; n++) Msg(ev, NOTE_OFF, (b * 11 + n * 5 + 64) & 127, 0);
+     }},
+};
+
+struct BlockCost {
+    double events;    // host cycles spent applying the block's events
+    double callback;  // host cycles spent rendering it
+    int    count;     // events in the block
+    int    quality;   // level the block was rendered at
+};
+
+// One pass over the scenario; per-block costs in host TSC cycles. With a
+// governor, each block's scaled cost sets the next block's quality.
+static void RunOnce(const Scenario& sc, int blocks, std::vector<BlockCost>& cost,
+                    QualityGovernor* gov = nullptr, double m7_factor = 1.0) {
+    OfflineSynth synth;
+    synth.Init(SR);
+    if (gov) gov->Init(SR / BLOCK);
+    std::vector<MidiMessage> ev;
+    float out[BLOCK];
+
+    for (int b = 0; b < blocks; b++) {
+        ev.clear();
+        sc.gen(b, ev);
+
+        uint64_t c0 = BenchCycles();
+        if (gov) synth.engine.ApplyVoiceCap(gov->Level());   // the main loop's part
+        for (const MidiMessage& m : ev) ApplyMessage(synth.engine, m);
+        uint64_t c1 = BenchCycles();
+        if (gov) synth.engine.SetQuality(gov->Level());
+        synth.engine.Process(out, BLOCK);
+        uint64_t c2 = BenchCycles();
+        DoNotOptimize(out[0]);
+        if (gov) gov->Update((uint32_t)((c2 - c1) * m7_factor), (uint32_t)DEADLINE);
+
+        BlockCost c{(double)(c1 - c0), (double)(c2 - c1), (int)ev.size(),
+                    synth.engine.Quality()};
+        if (cost.size() <= (size_t)b) cost.push_back(c);
+        else {
+            cost[b].events   = std::min(cost[b].events, c.events);
+            cost[b].callback = std::min(cost[b].callback, c.callback);
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    double m7_factor = 3.0;
+    int runs = 3;
+    double seconds = 2.0;
+    const char* only = nullptr;
+    bool govern = false;
+
+    for (int i = 1; i < argc; i++) {
+        bool has_val = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--m7-factor") && has_val)  m7_factor = std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "--runs") && has_val)    runs = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--seconds") && has_val) seconds = std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "--only") && has_val)    only = argv[++i];
+        else if (!std::strcmp(argv[i], "--govern"))             govern = true;
+        else {
+            std::fprintf(stderr, "usage: midi-storm [--m7-factor x] [--runs n] [--seconds s]"
+                                 " [--only name] [--govern]\n");
+            return 2;
+        }
+    }
+    if (BenchCycles() == 0) {
+        std::fprintf(stderr, "midi-storm needs a TSC (x86 host)\n");
+        return 2;
+    }
+    int blocks = std::max(1, (int)(seconds * SR / BLOCK));
+    if (runs < 1 || govern) runs = 1;
+
+    std::printf("deadline %.0f M7 cycles per %d-sample callback, host cycles x%.1f, "
+                "%s\n\n", DEADLINE, BLOCK, m7_factor,
+                govern ? "quality governor on" : "best of runs");
+    std::printf("%-16s %8s %8s %8s %8s %7s %7s %9s",
+                "scenario", "ev/blk", "worst", "p99", "mean", "misses", "starve", "worst at");
+    std::printf(govern ? " %5s %6s %8s\n" : "\n", "max Q", "steps", "degraded");
+
+    int total_misses = 0;
+    for (const Scenario& sc : SCENARIOS) {
+        if (only && std::strcmp(only, sc.name)) continue;
+        std::vector<BlockCost> cost;
+        QualityGovernor gov;
+        for (int r = 0; r < runs; r++) RunOnce(sc, blocks, cost, govern ? &gov : nullptr, m7_factor);
+
+        std::vector<double> cb(cost.size());
+        double sum = 0.0, worst = 0.0;
+        int worst_at = 0, misses = 0, starve = 0, max_q = 0, degraded = 0;
+        long events = 0;
+        for (size_t b = 0; b < cost.size(); b++) {
+            cb[b] = cost[b].callback * m7_factor / DEADLINE;
+            sum += cb[b];
+            events += cost[b].count;
+            if (cb[b] > worst) { worst = cb[b]; worst_at = (int)b; }
+            if (cb[b] > 1.0) misses++;
+            if ((cost[b].events + cost[b].callback) * m7_factor > DEADLINE) starve++;
+            max_q = std::max(max_q, cost[b].quality);
+            if (cost[b].quality > QUALITY_FULL) degraded++;
+        }
+        std::vector<double> sorted = cb;
+        std::sort(sorted.begin(), sorted.end());
+        double p99 = sorted[std::min(sorted.size() - 1, (size_t)(0.99 * sorted.size()))];
+
+        std::printf("%-16s %8.1f %7.1f%% %7.1f%% %7.1f%% %7d %7d %6.0f ms",
+                    sc.name, (double)events / blocks, 100.0 * worst, 100.0 * p99,
+                    100.0 * sum / blocks, misses, starve, worst_at * BLOCK / SR * 1000.0);
+        if (govern)
+            std::printf(" %5d %6u %7.1f%%\n", max_q, gov.Steps(), 100.0 * degraded / blocks);
+        else
+            std::printf("\n");
+        total_misses += misses;
+    }
+    std::printf("\n(callback cost as %% of the deadline; misses = callbacks over 100%%)\n");
+    return total_misses ? 1 : 0;
+}
@@ -0,0 +1,96 @@
+// =============================================================================
+// offline_render.cpp — Drive SynthEngine from timed MIDI messages
+// =============================================================================
+
+#include "offline_render.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <fstream>
+
+void ApplyMessage(SynthEngine& engine, const MidiMessage& m) {
+    if ((m.status & 0x0F) != MIDI_CHANNEL) return;
+    switch (m.status & 0xF0) {
+        case 0x90: engine.NoteOn(m.data1, m.data2); break;
+        case 0x80: engine.NoteOff(m.data1); break;
+        case 0xB0: engine.ControlChange(m.data1, m.data2); break;
+        case 0xE0: engine.PitchBend(m.data1 | (m.data2 << 7)); break;
+        default: break;
+    }
+}
+
+std::vector<float> RenderOffline(SynthEngine& engine, const std::vector<MidiMessage>& msgs,
+                                 const RenderOptions& opt) {
+    double end_s = (msgs.empty() ? 0.0 : msgs.back().time_s) + opt.tail_s;
+    size_t total = static_cast<size_t>(std::ceil(end_s * opt.sample_rate));
+    std::vector<float> out(total, 0.0f);
+
+    size_t next = 0;
+    for (size_t pos = 0; pos < total; pos += opt.block_size) {
+        // Everything due before the end of this block is applied up front
+        double block_end_s = (pos + opt.block_size) / static_cast<double>(opt.sample_rate);
+        while (next < msgs.size() && msgs[next].time_s < block_end_s)
+            ApplyMessage(engine, msgs[next++]);
+
+        int n = static_cast<int>(std::min<size_t>(opt.block_size, total - pos));
+        {
+            ProfileScope prof(engine.GetProfiler(), PROF_CALLBACK);
+            engine.Process(&out[pos], n);
+        }
+        engine.GetProfiler().EndBlock();
+    }
+    return out;
+}
+
+static uint8_t Clamp7(long v) {
+    return static_cast<uint8_t>(std::max(0L, std::min(127L, v)));
+}
+
+bool ReadAutomation(const std::string& path, std::vector<MidiMessage>& out, std::string& err) {
+    std::ifstream in(path);
+    if (!in) { err = "cannot open " + path; return false; }
+
+    const uint8_t status = 0xB0 | MIDI_CHANNEL;
+    std::string line;
+    int line_no = 0;
+    while (std::getline(in, line)) {
+        line_no++;
+        line = line.substr(0, line.find('#'));
+        std::istringstream ss(line);
+        std::string first;
+        if (!(ss >> first)) continue;
+
+        if (first == "ramp") {
+            double t0, t1;
+            long cc, v0, v1;
+            if (!(ss >> t0 >> t1 >> cc >> v0 >> v1) || t1 < t0) {
+                err = path + ":" + std::to_string(line_no) + ": bad ramp";
+                return false;
+            }
+            long steps = std::labs(v1 - v0);
+            for (long s = 0; s <= steps; s++) {
+                double frac = steps ? static_cast<double>(s) / steps : 1.0;
+                long v = v0 + (v1 > v0 ? s : -s);
+                out.push_back({t0 + frac * (t1 - t0), status, Clamp7(cc), Clamp7(v)});
+            }
+        } else {
+            long cc, v;
+            char* end = nullptr;
+            double t = std::strtod(first.c_str(), &end);
+            if (*end != '\0' || !(ss >> cc >> v)) {
+                err = path + ":" + std::to_string(line_no) + ": expected <time> <cc> <value>";
+                return false;
+            }
+            out.push_back({t, status, Clamp7(cc), Clamp7(v)});
+        }
+    }
+    return true;
+}
+
+void SortMessages(std::vector<MidiMessage>& msgs) {
+    std::stable_sort(msgs.begin(), msgs.end(), [](const MidiMessage& a, const MidiMessage& b) {
+        return a.time_s < b.time_s;
+    });
+}
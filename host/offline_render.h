@@ -0,0 +1,53 @@
+#pragma once
+// =============================================================================
+// offline_render.h — Drive SynthEngine from timed MIDI messages (host only)
+// =============================================================================
+// Shared by the renderer CLI and every host test/benchmark that needs real
+// audio out of the DSP core. Messages are applied at block boundaries, the
+// same granularity the firmware main loop gives PollMidi().
+// =============================================================================
+
+#include "smf.h"
+#include "synth_engine.h"
+#include "denormals.h"
+#include <string>
+#include <vector>
+
+// SynthEngine plus a plain heap buffer standing in for the SDRAM arena
+struct OfflineSynth {
+    static constexpr size_t ARENA_FLOATS = 128 * 1024;
+
+    // Also sets flush-to-zero for the calling thread, as the Seed runs
+    bool Init(float sample_rate) {
+        EnableFlushToZero();
+        arena_mem.assign(ARENA_FLOATS, 0.0f);
+        arena.Init(arena_mem.data(), arena_mem.size());
+        return engine.Init(sample_rate, arena);
+    }
+
+    std::vector<float> arena_mem;
+    Arena arena;
+    SynthEngine engine;
+};
+
+struct RenderOptions {
+    float  sample_rate = 48000.0f;
+    int    block_size  = 48;
+    double tail_s      = 2.0;   // keep rendering after the last message
+};
+
+// Apply one message the way main.cpp does (channel 1 only)
+void ApplyMessage(SynthEngine& engine, const MidiMessage& m);
+
+// Render messages (sorted by time) into a mono buffer
+std::vector<float> RenderOffline(SynthEngine& engine, const std::vector<MidiMessage>& msgs,
+                                 const RenderOptions& opt);
+
+// CC automation text file, one entry per line ('#' starts a comment):
+//   <time_s> <cc> <value>                      single CC message
+//   ramp <t0_s> <t1_s> <cc> <v0> <v1>          one message per value step
+// Messages go out on channel 1. Appends to out (unsorted).
+bool ReadAutomation(const std::string& path, std::vector<MidiMessage>& out, std::string& err);
+
+// Stable sort by time — merge SMF messages with automation
+void SortMessages(std::vector<MidiMessage>& msgs);
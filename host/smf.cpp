@@ -0,0 +1,139 @@
+// =============================================================================
+// smf.cpp — Minimal Standard MIDI File reader
+// =============================================================================
+
+#include "smf.h"
+#include <algorithm>
+#include <cstdio>
+#include <map>
+
+namespace {
+
+struct Reader {
+    const std::vector<uint8_t>& d;
+    size_t pos;
+    size_t end;
+
+    bool Has(size_t n) const { return pos + n <= end; }
+    uint8_t U8() { return d[pos++]; }
+    uint32_t U16() { uint32_t v = (d[pos] << 8) | d[pos + 1]; pos += 2; return v; }
+    uint32_t U32() {
+        uint32_t v = (d[pos] << 24) | (d[pos + 1] << 16) | (d[pos + 2] << 8) | d[pos + 3];
+        pos += 4;
+        return v;
+    }
+    bool VarLen(uint32_t& v) {
+        v = 0;
+        for (int i = 0; i < 4; i++) {
+            if (!Has(1)) return false;
+            uint8_t b = U8();
+            v = (v << 7) | (b & 0x7F);
+            if (!(b & 0x80)) return true;
+        }
+        return false;
+    }
+};
+
+// Message in ticks, before the tempo map is applied
+struct TickMessage {
+    uint64_t tick;
+    int      order;  // file order, keeps simultaneous events stable
+    uint8_t  status, data1, data2;
+};
+
+}  // namespace
+
+bool ReadSmf(const std::string& path, std::vector<MidiMessage>& out, std::string& err) {
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) { err = "cannot open " + path; return false; }
+    std::vector<uint8_t> data;
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = std::fread(chunk, 1, sizeof(chunk), f)) > 0)
+        data.insert(data.end(), chunk, chunk + n);
+    std::fclose(f);
+
+    Reader r{data, 0, data.size()};
+    if (!r.Has(14) || r.U32() != 0x4D546864 /* MThd */) { err = "not a MIDI file"; return false; }
+    uint32_t hdr_len = r.U32();
+    uint32_t format  = r.U16();
+    uint32_t ntracks = r.U16();
+    uint32_t division = r.U16();
+    r.pos += hdr_len - 6;
+    if (format > 1) { err = "format 2 not supported"; return false; }
+    if (division & 0x8000) { err = "SMPTE time division not supported"; return false; }
+
+    std::vector<TickMessage> msgs;
+    std::map<uint64_t, uint32_t> tempo;  // tick → µs per quarter
+    tempo[0] = 500000;
+    int order = 0;
+
+    for (uint32_t t = 0; t < ntracks; t++) {
+        if (!r.Has(8)) { err = "truncated file"; return false; }
+        uint32_t id  = r.U32();
+        uint32_t len = r.U32();
+        if (!r.Has(len)) { err = "truncated track"; return false; }
+        if (id != 0x4D54726B /* MTrk */) { r.pos += len; continue; }
+
+        Reader tr{data, r.pos, r.pos + len};
+        r.pos += len;
+        uint64_t tick = 0;
+        uint8_t running = 0;
+        while (tr.Has(1)) {
+            uint32_t delta;
+            if (!tr.VarLen(delta) || !tr.Has(1)) { err = "bad delta time"; return false; }
+            tick += delta;
+            uint8_t status = tr.d[tr.pos];
+            if (status & 0x80) tr.pos++;
+            else if (running) status = running;
+            else { err = "running status without status"; return false; }
+
+            if (status == 0xFF) {
+                if (!tr.Has(1)) break;
+                uint8_t type = tr.U8();
+                uint32_t mlen;
+                if (!tr.VarLen(mlen) || !tr.Has(mlen)) { err = "bad meta event"; return false; }
+                if (type == 0x51 && mlen == 3)
+                    tempo[tick] = (tr.d[tr.pos] << 16) | (tr.d[tr.pos + 1] << 8) | tr.d[tr.pos + 2];
+                tr.pos += mlen;
+                if (type == 0x2F) break;  // end of track
+            } else if (status == 0xF0 || status == 0xF7) {
+                uint32_t slen;
+                if (!tr.VarLen(slen) || !tr.Has(slen)) { err = "bad sysex"; return false; }
+                tr.pos += slen;
+            } else {
+                running = status;
+                int nbytes = ((status & 0xE0) == 0xC0) ? 1 : 2;  // Cx, Dx take one
+                if (!tr.Has(nbytes)) { err = "truncated event"; return false; }
+                uint8_t d1 = tr.U8();
+                uint8_t d2 = nbytes == 2 ? tr.U8() : 0;
+                msgs.push_back({tick, order++, status, d1, d2});
+            }
+        }
+    }
+
+    std::stable_sort(msgs.begin(), msgs.end(), [](const TickMessage& a, const TickMessage& b) {
+        return a.tick < b.tick;
+    });
+
+    // Walk the tempo map alongside the sorted messages
+    out.clear();
+    out.reserve(msgs.size());
+    auto seg = tempo.begin();
+    uint64_t seg_tick = 0;
+    double seg_time = 0.0;
+    double us_per_tick = seg->second / static_cast<double>(division);
+    for (const TickMessage& m : msgs) {
+        auto next = std::next(seg);
+        while (next != tempo.end() && next->first <= m.tick) {
+            seg_time += (next->first - seg_tick) * us_per_tick * 1e-6;
+            seg_tick = next->first;
+            us_per_tick = next->second / static_cast<double>(division);
+            seg = next;
+            next = std::next(seg);
+        }
+        double t = seg_time + (m.tick - seg_tick) * us_per_tick * 1e-6;
+        out.push_back({t, m.status, m.data1, m.data2});
+    }
+    return true;
+}
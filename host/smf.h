@@ -0,0 +1,22 @@
+#pragma once
+// =============================================================================
+// smf.h — Minimal Standard MIDI File reader (host only)
+// =============================================================================
+// Reads format 0 and 1 files, follows the tempo map, and flattens all
+// tracks into one time-ordered list of channel voice messages. SysEx and
+// meta events other than tempo are skipped.
+// =============================================================================
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct MidiMessage {
+    double  time_s;   // absolute time from the start of the file
+    uint8_t status;   // 0x80–0xEF (channel in low nibble)
+    uint8_t data1;
+    uint8_t data2;
+};
+
+// Returns false and fills err on malformed input
+bool ReadSmf(const std::string& path, std::vector<MidiMessage>& out, std::string& err);
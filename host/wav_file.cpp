@@ -0,0 +1,91 @@
+// =============================================================================
+// wav_file.cpp — Mono WAV read/write
+// =============================================================================
+
+#include "wav_file.h"
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+static void Put16(std::FILE* f, uint16_t v) { std::fwrite(&v, 2, 1, f); }
+static void Put32(std::FILE* f, uint32_t v) { std::fwrite(&v, 4, 1, f); }
+
+bool WriteWav(const std::string& path, const std::vector<float>& samples,
+              int sample_rate, bool pcm16) {
+    std::FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) return false;
+
+    uint16_t bits = pcm16 ? 16 : 32;
+    uint32_t data_bytes = static_cast<uint32_t>(samples.size() * (bits / 8));
+    std::fwrite("RIFF", 1, 4, f);
+    Put32(f, 36 + data_bytes);
+    std::fwrite("WAVEfmt ", 1, 8, f);
+    Put32(f, 16);
+    Put16(f, pcm16 ? 1 : 3);  // PCM or IEEE float
+    Put16(f, 1);              // mono
+    Put32(f, sample_rate);
+    Put32(f, sample_rate * (bits / 8));
+    Put16(f, bits / 8);
+    Put16(f, bits);
+    std::fwrite("data", 1, 4, f);
+    Put32(f, data_bytes);
+
+    if (pcm16) {
+        std::vector<int16_t> pcm(samples.size());
+        for (size_t i = 0; i < samples.size(); i++) {
+            float x = std::fmax(-1.0f, std::fmin(1.0f, samples[i]));
+            pcm[i] = static_cast<int16_t>(std::lrint(x * 32767.0f));
+        }
+        std::fwrite(pcm.data(), 2, pcm.size(), f);
+    } else {
+        std::fwrite(samples.data(), 4, samples.size(), f);
+    }
+    bool ok = std::ferror(f) == 0;
+    std::fclose(f);
+    return ok;
+}
+
+bool ReadWav(const std::string& path, std::vector<float>& samples, int& sample_rate) {
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) return false;
+
+    char id[4];
+    uint32_t len;
+    uint16_t fmt = 0, channels = 0, bits = 0;
+    bool ok = std::fread(id, 1, 4, f) == 4 && std::memcmp(id, "RIFF", 4) == 0
+           && std::fread(&len, 4, 1, f) == 1
+           && std::fread(id, 1, 4, f) == 4 && std::memcmp(id, "WAVE", 4) == 0;
+
+    // Walk chunks until "data", picking up "fmt " on the way
+    while (ok && std::fread(id, 1, 4, f) == 4 && std::fread(&len, 4, 1, f) == 1) {
+        if (std::memcmp(id, "fmt ", 4) == 0) {
+            uint32_t rate;
+            ok = std::fread(&fmt, 2, 1, f) == 1 && std::fread(&channels, 2, 1, f) == 1
+              && std::fread(&rate, 4, 1, f) == 1;
+            sample_rate = static_cast<int>(rate);
+            std::fseek(f, 6, SEEK_CUR);  // byte rate, block align
+            ok = ok && std::fread(&bits, 2, 1, f) == 1;
+            std::fseek(f, len - 16, SEEK_CUR);
+        } else if (std::memcmp(id, "data", 4) == 0) {
+            if (channels != 1) { ok = false; break; }
+            if (fmt == 3 && bits == 32) {
+                samples.resize(len / 4);
+                ok = std::fread(samples.data(), 4, samples.size(), f) == samples.size();
+            } else if (fmt == 1 && bits == 16) {
+                std::vector<int16_t> pcm(len / 2);
+                ok = std::fread(pcm.data(), 2, pcm.size(), f) == pcm.size();
+                samples.resize(pcm.size());
+                for (size_t i = 0; i < pcm.size(); i++) samples[i] = pcm[i] / 32767.0f;
+            } else {
+                ok = false;
+            }
+            std::fclose(f);
+            return ok;
+        } else {
+            std::fseek(f, len + (len & 1), SEEK_CUR);
+        }
+    }
+    std::fclose(f);
+    return false;
+}
@@ -0,0 +1,14 @@
+#pragma once
+// =============================================================================
+// wav_file.h — Mono WAV read/write (host only)
+// =============================================================================
+// Writes 32-bit float or 16-bit PCM. Reads either back as float.
+// =============================================================================
+
+#include <string>
+#include <vector>
+
+bool WriteWav(const std::string& path, const std::vector<float>& samples,
+              int sample_rate, bool pcm16 = false);
+
+bool ReadWav(const std::string& path, std::vector<float>& samples, int& sample_rate);
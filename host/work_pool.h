@@ -0,0 +1,78 @@
+#pragma once
+// =============================================================================
+// work_pool.h — Work-stealing pool for independent, indexed jobs (host only)
+// =============================================================================
+// Run(n, fn) calls fn(job, worker) once for every job in [0, n). Each worker
+// starts with a contiguous slice of the indices in its own deque, pops from
+// the back of it, and when empty steals from the front of another worker's —
+// the biggest remaining chunk of someone else's work. Jobs must not depend on
+// which worker runs them or in what order; results go to per-job slots.
+// =============================================================================
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WorkStealingPool {
+public:
+    // threads < 1 means one per hardware thread
+    explicit WorkStealingPool(int threads) {
+        if (threads < 1) threads = static_cast<int>(std::thread::hardware_concurrency());
+        threads_ = threads < 1 ? 1 : threads;
+    }
+
+    int Threads() const { return threads_; }
+
+    void Run(size_t jobs, const std::function<void(size_t job, int worker)>& fn) {
+        std::vector<Queue> queues(threads_);
+        for (int w = 0; w < threads_; w++) {
+            size_t lo = jobs * w / threads_, hi = jobs * (w + 1) / threads_;
+            for (size_t j = lo; j < hi; j++) queues[w].jobs.push_back(j);
+        }
+
+        auto worker = [&](int w) {
+            size_t job;
+            while (PopLocal(queues[w], job) || Steal(queues, w, job))
+                fn(job, w);
+        };
+
+        std::vector<std::thread> pool;
+        for (int w = 1; w < threads_; w++) pool.emplace_back(worker, w);
+        worker(0);
+        for (std::thread& t : pool) t.join();
+    }
+
+private:
+    struct Queue {
+        std::mutex         lock;
+        std::deque<size_t> jobs;
+    };
+
+    static bool PopLocal(Queue& q, size_t& job) {
+        std::lock_guard<std::mutex> g(q.lock);
+        if (q.jobs.empty()) return false;
+        job = q.jobs.back();
+        q.jobs.pop_back();
+        return true;
+    }
+
+    // Victims are tried round-robin from the thief's neighbour. No job is
+    // ever added after Run starts, so one empty sweep means all work is taken.
+    bool Steal(std::vector<Queue>& queues, int thief, size_t& job) const {
+        for (int i = 1; i < threads_; i++) {
+            Queue& v = queues[(thief + i) % threads_];
+            std::lock_guard<std::mutex> g(v.lock);
+            if (v.jobs.empty()) continue;
+            job = v.jobs.front();
+            v.jobs.pop_front();
+            return true;
+        }
+        return false;
+    }
+
+    int threads_;
+};
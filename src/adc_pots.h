@@ -1,37 +1,24 @@
 #pragma once
 // =============================================================================
-// adc_pots.h — Read 9 potentiometers via ADC with smoothing + dead-zone
+// adc_pots.h — Read 9 potentiometers via ADC with adaptive smoothing
 // =============================================================================
 // Header-only. Call AdcPotsInit() once at startup, then AdcPotsRead() each
 // iteration of the main loop. Pots write to the same cc_* fields that MIDI
-// uses — last write wins, with a dead-zone so a stationary pot doesn't
-// overwrite incoming MIDI CCs.
+// uses — last write wins, with hysteresis so a stationary pot doesn't
+// overwrite incoming MIDI CCs. Smoothing lives in pot_filter.h.
 // =============================================================================
 
 #include "daisy_seed.h"
 #include "params.h"
-#include <cmath>
+#include "pot_filter.h"
 
 inline constexpr int NUM_POTS = 9;
-inline constexpr float POT_DEAD_ZONE = 0.02f;   // 2% — ~3 steps on 0-127 display
-inline constexpr float POT_SMOOTH_ALPHA = 0.3f;  // IIR: 30% new (~150ms settle at 20fps)
 inline constexpr float POT_RAW_MIN = 0.01f;      // ADC floor (allow for wiper offset)
 inline constexpr float POT_RAW_MAX = 0.93f;      // ADC ceiling (pots read ~955-972 at full CW)
 
-// Persistent state for median filter, smoothing, and dead-zone
-static float pot_history[NUM_POTS][3];  // last 3 raw readings for median
-static int   pot_hist_idx = 0;          // ring buffer write position
-static float pot_smoothed[NUM_POTS];
-static float pot_last_sent[NUM_POTS];
-static bool  pot_initialized = false;
-
-// Median of three — kills impulse spikes that IIR can't
-static inline float Median3(float a, float b, float c) {
-    if (a > b) { float t = a; a = b; b = t; }
-    if (b > c) { b = c; }
-    if (a > b) { a = b; }
-    return a > b ? a : b;  // middle value
-}
+// Shared tuning for all pots, and one filter state per pot
+static PotFilterConfig pot_filter_cfg;
+static PotFilter       pot_filters[NUM_POTS];
 
 // Map pot index to the Params cc_* field it controls.
 // Pots are arranged counter-clockwise starting top-right, matching the
@@ -72,42 +59,23 @@ static inline void AdcPotsInit(daisy::DaisySeed& hw) {
     hw.adc.Start();
 }
 
-// Read all pots, apply IIR smoothing, update params if pot moved past dead-zone
-static inline void AdcPotsRead(daisy::DaisySeed& hw, Params& params) {
+// Read all pots, filter, update params for any pot that is being moved.
+// dt_s is the time since the previous call (the 1-Euro cutoff depends on it).
+static inline void AdcPotsRead(daisy::DaisySeed& hw, Params& params, float dt_s) {
     bool changed = false;
 
     for (int i = 0; i < NUM_POTS; i++) {
         float raw = (hw.adc.GetFloat(i) - POT_RAW_MIN) / (POT_RAW_MAX - POT_RAW_MIN);
         if (raw < 0.0f) raw = 0.0f;
         if (raw > 1.0f) raw = 1.0f;
-        pot_history[i][pot_hist_idx] = raw;
 
-        if (!pot_initialized) {
-            // First 3 calls: fill history, then snap to physical position
-            pot_history[i][0] = pot_history[i][1] = pot_history[i][2] = raw;
-            pot_smoothed[i]  = raw;
-            pot_last_sent[i] = raw;
-            PotTarget(params, i) = raw;
+        // First call snaps to the physical position; after that only a
+        // moving pot gets past the hysteresis window
+        if (pot_filters[i].Process(raw, dt_s, pot_filter_cfg)) {
+            PotTarget(params, i) = pot_filters[i].Value(pot_filter_cfg);
             changed = true;
-        } else {
-            // Median of last 3 readings — rejects I2C impulse noise
-            float med = Median3(pot_history[i][0],
-                                pot_history[i][1],
-                                pot_history[i][2]);
-
-            // IIR one-pole low-pass on the median value
-            pot_smoothed[i] += POT_SMOOTH_ALPHA * (med - pot_smoothed[i]);
-
-            // Only update param if pot moved past dead-zone
-            if (std::fabs(pot_smoothed[i] - pot_last_sent[i]) > POT_DEAD_ZONE) {
-                pot_last_sent[i] = pot_smoothed[i];
-                PotTarget(params, i) = pot_smoothed[i];
-                changed = true;
-            }
         }
     }
 
-    pot_hist_idx = (pot_hist_idx + 1) % 3;
-    if (!pot_initialized) pot_initialized = true;
-    if (changed) params.Update();
+    if (changed) params.Changed();   // the audio thread recomputes (Params::Advance)
 }
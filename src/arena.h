@@ -0,0 +1,93 @@
+#pragma once
+// =============================================================================
+// arena.h — Static bump allocator for DSP buffers (delay lines, FFT scratch)
+// =============================================================================
+// Header-only, no Daisy dependencies. The arena never owns memory: the
+// caller hands it a static array at startup. On the Seed that array lives in
+// external SDRAM (DSY_SDRAM_BSS, see main.cpp); on the host it's a plain
+// static buffer. Allocation only happens during Init() — never from the
+// audio callback — and there is no free. Returns nullptr when exhausted.
+//
+// ScratchArena is the per-block counterpart: a fixed stack of floats that
+// stages borrow temporaries from inside the audio callback and hand back
+// when their ScratchFrame goes out of scope. Stages that never run at the
+// same time share the same memory.
+// =============================================================================
+
+#include <cstddef>
+#include <cstring>
+
+class Arena {
+public:
+    void Init(float* mem, size_t capacity) {
+        mem_ = mem;
+        capacity_ = capacity;
+        used_ = 0;
+    }
+
+    // Zeroed block of n floats, aligned to 8 floats (32 bytes, one M7
+    // cache line) so separate delay lines never share a line.
+    float* Alloc(size_t n) {
+        size_t start = (used_ + 7) & ~static_cast<size_t>(7);
+        if (mem_ == nullptr || start + n > capacity_) return nullptr;
+        used_ = start + n;
+        std::memset(mem_ + start, 0, n * sizeof(float));
+        return mem_ + start;
+    }
+
+    size_t Used() const { return used_; }
+    size_t Capacity() const { return capacity_; }
+
+private:
+    float* mem_ = nullptr;
+    size_t capacity_ = 0;
+    size_t used_ = 0;
+};
+
+class ScratchArena {
+public:
+    void Init(float* mem, size_t capacity) {
+        mem_ = mem;
+        capacity_ = capacity;
+        top_ = 0;
+        peak_ = 0;
+    }
+
+    // n floats, uninitialised, aligned like Arena::Alloc. Real-time safe.
+    // Callers size the arena at Init so this cannot run out; if it does,
+    // the result is nullptr.
+    float* Take(size_t n) {
+        size_t start = (top_ + 7) & ~static_cast<size_t>(7);
+        if (mem_ == nullptr || start + n > capacity_) return nullptr;
+        top_ = start + n;
+        if (top_ > peak_) peak_ = top_;
+        return mem_ + start;
+    }
+
+    size_t Mark() const { return top_; }
+    void Rewind(size_t mark) { top_ = mark; }
+
+    size_t Peak() const { return peak_; }   // high-water mark, floats
+    size_t Capacity() const { return capacity_; }
+
+private:
+    float* mem_ = nullptr;
+    size_t capacity_ = 0;
+    size_t top_ = 0;
+    size_t peak_ = 0;
+};
+
+// Everything taken through a frame is returned when it goes out of scope
+class ScratchFrame {
+public:
+    explicit ScratchFrame(ScratchArena& s) : s_(s), mark_(s.Mark()) {}
+    ~ScratchFrame() { s_.Rewind(mark_); }
+    ScratchFrame(const ScratchFrame&) = delete;
+    ScratchFrame& operator=(const ScratchFrame&) = delete;
+
+    float* Take(size_t n) { return s_.Take(n); }
+
+private:
+    ScratchArena& s_;
+    size_t mark_;
+};
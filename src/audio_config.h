@@ -0,0 +1,47 @@
+#pragma once
+// =============================================================================
+// audio_config.h — Sample rate, block size and FX rate for the firmware build
+// =============================================================================
+// Everything rate-dependent (oscillator increments, envelope and filter
+// coefficients, delay-line lengths, FX sleep timing) is derived from the
+// values passed to SynthEngine::Init, so these are the only two knobs:
+//
+//   make SAMPLE_RATE=96000        48000 (default) or 96000
+//   make BLOCK_SIZE=16            4–256 samples per callback (default 48)
+//   make LOW_LATENCY=1            8-sample blocks: ~0.17 ms per callback at
+//                                 48 kHz, for finger drumming
+//   make FX_DECIMATION=4          chorus + reverb at 1/1, 1/2 (default) or
+//                                 1/4 of the sample rate
+//
+// Run `make clean` after changing any of them. The host tools take the same
+// values at run time (--sr, --block).
+// =============================================================================
+
+#ifndef MS20_SAMPLE_RATE
+#define MS20_SAMPLE_RATE 48000
+#endif
+
+#ifndef MS20_BLOCK_SIZE
+#if defined(MS20_LOW_LATENCY) && MS20_LOW_LATENCY
+#define MS20_BLOCK_SIZE 8
+#else
+#define MS20_BLOCK_SIZE 48
+#endif
+#endif
+
+#ifndef MS20_FX_DECIMATION
+#define MS20_FX_DECIMATION 2
+#endif
+
+constexpr int AUDIO_SAMPLE_RATE = MS20_SAMPLE_RATE;
+constexpr int AUDIO_BLOCK_SIZE  = MS20_BLOCK_SIZE;
+constexpr int AUDIO_MIN_BLOCK   = 4;
+constexpr int AUDIO_MAX_BLOCK   = 256;
+constexpr int FX_DECIMATION     = MS20_FX_DECIMATION;
+
+static_assert(AUDIO_SAMPLE_RATE == 48000 || AUDIO_SAMPLE_RATE == 96000,
+              "MS20_SAMPLE_RATE must be 48000 or 96000");
+static_assert(AUDIO_BLOCK_SIZE >= AUDIO_MIN_BLOCK && AUDIO_BLOCK_SIZE <= AUDIO_MAX_BLOCK,
+              "MS20_BLOCK_SIZE must be 4–256");
+static_assert(FX_DECIMATION == 1 || FX_DECIMATION == 2 || FX_DECIMATION == 4,
+              "MS20_FX_DECIMATION must be 1, 2 or 4");
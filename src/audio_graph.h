@@ -0,0 +1,115 @@
+#pragma once
+// =============================================================================
+// audio_graph.h — Compile-time audio graph: stages as types, fused loops
+// =============================================================================
+// A graph is a type list of stages run in order over one mono block, in
+// place. There are no virtual calls and no per-stage buffers. It knows two
+// kinds of stage:
+//
+//   Block stage      static void Run(Ctx&, float* buf, int n)
+//                    Whole-block DSP with its own state: voices, FX. Any
+//                    temporaries come from the ScratchArena (arena.h).
+//
+//   Pointwise stage  static constexpr bool POINTWISE = true;
+//                    explicit S(const Ctx&)       per-block constants
+//                    float operator()(float) const
+//                    Memoryless sample maps: gains, clippers, mixes.
+//
+// Consecutive pointwise stages are fused into one loop (one load and one
+// store per sample whatever their count), and a trailing run also does
+// the write to the mirror channel. Adding a stage means adding a type to
+// the list; the callback doesn't change.
+//
+// Every stage names the profiler row it is charged to (PROFILE); a fused
+// run is charged to its first stage's row. Ctx provides GetProfiler().
+// Header-only, no Daisy dependencies.
+// =============================================================================
+
+#include "cycle_profiler.h"
+
+template <typename... Stages>
+struct StageList {};
+
+namespace audio_graph_detail {
+
+template <typename S, typename = void>
+struct IsPointwise { static constexpr bool value = false; };
+template <typename S>
+struct IsPointwise<S, decltype(void(S::POINTWISE))> { static constexpr bool value = S::POINTWISE; };
+
+// One loop over the block through every stage in P, writing buf and,
+// if given, mirror
+template <typename Ctx, typename... P>
+struct Fused {
+    static void Run(Ctx& c, float* buf, float* mirror, int n) {
+        if constexpr (sizeof...(P) > 0) {
+            ProfileScope scope(c.GetProfiler(), First<P...>::PROFILE);
+            Loop(buf, mirror, n, P(c)...);
+        } else if (mirror) {
+            for (int i = 0; i < n; i++) mirror[i] = buf[i];
+        }
+    }
+
+private:
+    template <typename F, typename...>
+    struct FirstOf { using type = F; };
+    template <typename... Q>
+    using First = typename FirstOf<Q...>::type;
+
+    template <typename... Q>
+    static void Loop(float* buf, float* mirror, int n, const Q&... stage) {
+        if (mirror) {
+            for (int i = 0; i < n; i++) {
+                float x = buf[i];
+                ((x = stage(x)), ...);
+                buf[i] = x;
+                mirror[i] = x;
+            }
+        } else {
+            for (int i = 0; i < n; i++) {
+                float x = buf[i];
+                ((x = stage(x)), ...);
+                buf[i] = x;
+            }
+        }
+    }
+};
+
+// Walks the stage list, collecting pointwise stages in Pending until a
+// block stage (or the end) flushes them as one fused loop
+template <typename Ctx, typename Pending, typename... Rest>
+struct Walk;
+
+template <typename Ctx, typename... P>
+struct Walk<Ctx, StageList<P...>> {
+    static void Run(Ctx& c, float* buf, float* mirror, int n) {
+        Fused<Ctx, P...>::Run(c, buf, mirror, n);
+    }
+};
+
+template <typename Ctx, typename... P, typename S, typename... Rest>
+struct Walk<Ctx, StageList<P...>, S, Rest...> {
+    static void Run(Ctx& c, float* buf, float* mirror, int n) {
+        if constexpr (IsPointwise<S>::value) {
+            Walk<Ctx, StageList<P..., S>, Rest...>::Run(c, buf, mirror, n);
+        } else {
+            Fused<Ctx, P...>::Run(c, buf, nullptr, n);
+            {
+                ProfileScope scope(c.GetProfiler(), S::PROFILE);
+                S::Run(c, buf, n);
+            }
+            Walk<Ctx, StageList<>, Rest...>::Run(c, buf, mirror, n);
+        }
+    }
+};
+
+}  // namespace audio_graph_detail
+
+template <typename Ctx, typename... Stages>
+struct AudioGraph {
+    // Run every stage over buf[0..n) in place; mirror (optional) gets a
+    // copy of the result from the last loop that touches it
+    static void Run(Ctx& c, float* buf, int n, float* mirror = nullptr) {
+        audio_graph_detail::Walk<Ctx, StageList<>, Stages...>::Run(c, buf, mirror, n);
+    }
+};
@@ -0,0 +1,46 @@
+#pragma once
+// =============================================================================
+// boot_profile.h — Timestamps for the startup phases
+// =============================================================================
+// main() marks the end of each startup phase on the microsecond clock:
+// first the phases before the main loop starts (everything the first note
+// needs), then the stages the loop runs afterwards, one per wake (the
+// display, the output views, the SD card). A phase runs from the previous
+// mark to its own, so the first one also covers the time from the clock
+// starting up to main(), and a deferred stage covers the loop work done
+// in between. The CC 119 boot page shows them (main.cpp).
+//
+// Header-only, no Daisy dependencies. Main loop only.
+// =============================================================================
+
+#include <cstdint>
+
+class BootProfile {
+public:
+    static constexpr int MAX_PHASES = 9;   // EyeRenderer::STAT_ROWS
+
+    struct Phase {
+        char     label[3];   // two letters for the stats page
+        uint32_t end_us;     // since the clock started
+    };
+
+    // The phase labelled label ends now. Marks past MAX_PHASES are dropped.
+    void Mark(const char* label, uint32_t now_us) {
+        if (count_ >= MAX_PHASES) return;
+        Phase& p = phases_[count_++];
+        p.label[0] = label[0];
+        p.label[1] = label[0] ? label[1] : 0;
+        p.label[2] = 0;
+        p.end_us = now_us;
+    }
+
+    int Count() const { return count_; }
+    const Phase& Get(int i) const { return phases_[i]; }
+    uint32_t DurationUs(int i) const {
+        return phases_[i].end_us - (i > 0 ? phases_[i - 1].end_us : 0);
+    }
+
+private:
+    Phase phases_[MAX_PHASES];
+    int   count_ = 0;
+};
@@ -0,0 +1,64 @@
+#pragma once
+// =============================================================================
+// capture_ring.h — Decimated single-producer/single-consumer capture ring
+// =============================================================================
+// The audio callback pushes its output. Every DECIMATE samples are
+// averaged into one slot of an N-slot ring, and the running write count is
+// published once per block. The main loop copies out the newest samples
+// whenever it wants them. Neither side waits. The reader checks the count
+// again after copying and reports a torn copy if the writer lapped it
+// meanwhile. At a few kB per frame that can't happen unless the main loop
+// stalls for N × DECIMATE samples.
+//
+// Header-only, no Daisy dependencies. Push runs on the audio thread,
+// Latest on the main loop.
+// =============================================================================
+
+#include <atomic>
+#include <cstdint>
+
+template <int N, int DECIMATE>
+class CaptureRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "ring size must be a power of two");
+    static_assert(DECIMATE >= 1, "decimation must be at least 1");
+
+public:
+    static constexpr int SIZE = N;
+
+    // --- Audio thread ---
+
+    void Push(const float* x, int n) {
+        uint32_t w = written_.load(std::memory_order_relaxed);
+        for (int i = 0; i < n; i++) {
+            acc_ += x[i];
+            if (++phase_ == DECIMATE) {
+                buf_[w & (N - 1)] = acc_ * (1.0f / DECIMATE);
+                w++;
+                acc_ = 0.0f;
+                phase_ = 0;
+            }
+        }
+        written_.store(w, std::memory_order_release);
+    }
+
+    // --- Main loop ---
+
+    // The newest count samples (count ≤ N), oldest first. False if fewer
+    // have been captured, or the writer overwrote them during the copy.
+    bool Latest(float* dst, int count) const {
+        uint32_t end = written_.load(std::memory_order_acquire);
+        if (count > N || end < static_cast<uint32_t>(count)) return false;
+        uint32_t start = end - static_cast<uint32_t>(count);
+        for (int i = 0; i < count; i++) dst[i] = buf_[(start + i) & (N - 1)];
+        uint32_t after = written_.load(std::memory_order_acquire);
+        return after - start <= static_cast<uint32_t>(N);
+    }
+
+    uint32_t Written() const { return written_.load(std::memory_order_relaxed); }
+
+private:
+    float buf_[N] = {};
+    std::atomic<uint32_t> written_{0};   // samples ever written (wraps)
+    float acc_ = 0.0f;
+    int   phase_ = 0;
+};
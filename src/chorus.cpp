@@ -0,0 +1,59 @@
+// =============================================================================
+// chorus.cpp — Mono chorus implementation
+// =============================================================================
+
+#include "chorus.h"
+#include <cstring>
+
+bool Chorus::Init(float sample_rate, Arena& arena, float latency) {
+    base_  = BASE_MS * 0.001f * sample_rate - latency;
+    swing_ = DEPTH * SWING_MS * 0.001f * sample_rate;
+
+    // Power-of-two line covering the deepest read plus interpolation tap
+    int need = static_cast<int>(base_ + swing_) + 2;
+    int size = 1;
+    while (size < need) size <<= 1;
+    buf_  = arena.Alloc(size);
+    mask_ = size - 1;
+
+    write_     = 0;
+    lfo_phase_ = 0.0f;
+    lfo_inc_   = RATE_HZ / sample_rate;
+    return buf_ != nullptr;
+}
+
+void Chorus::Clear() {
+    std::memset(buf_, 0, (mask_ + 1) * sizeof(float));
+}
+
+void Chorus::ProcessBlock(const float* in, float* out, int n) {
+    Render<true>(in, out, n);
+}
+
+void Chorus::ProcessWet(const float* in, float* out, int n) {
+    Render<false>(in, out, n);
+}
+
+template <bool DRY>
+void Chorus::Render(const float* in, float* out, int n) {
+    for (int i = 0; i < n; i++) {
+        // Triangle LFO, -1..+1
+        lfo_phase_ += lfo_inc_;
+        if (lfo_phase_ >= 1.0f) lfo_phase_ -= 1.0f;
+        float tri = 4.0f * (lfo_phase_ < 0.5f ? lfo_phase_ : 1.0f - lfo_phase_) - 1.0f;
+
+        // Fractional read with linear interpolation
+        float delay = base_ + swing_ * tri;
+        int   d_int = static_cast<int>(delay);
+        float frac  = delay - static_cast<float>(d_int);
+        float a = buf_[(write_ - d_int) & mask_];
+        float b = buf_[(write_ - d_int - 1) & mask_];
+        float wet = a + frac * (b - a);
+
+        float x = in ? in[i] : 0.0f;
+        buf_[write_] = x + FEEDBACK * wet;
+        write_ = (write_ + 1) & mask_;
+
+        out[i] = DRY ? 0.5f * (x + wet) : 0.5f * wet;
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+// =============================================================================
+// chorus.h — Mono chorus (SPEC §6.1): 0.8 Hz, 40% depth, 20% feedback
+// =============================================================================
+// Block-processed, no Daisy dependencies. The delay line comes from an Arena
+// so it can live in SDRAM on the Seed. Output is the classic 50/50 mix of
+// dry and modulated delay — "fully wet chorus" in the SPEC §6.3 sense.
+// =============================================================================
+
+#include "arena.h"
+
+class Chorus {
+public:
+    // Returns false if the arena can't hold the delay line. latency is
+    // delay (in samples at sample_rate) the caller adds around the chorus;
+    // it comes off the centre delay so the wet still lines up with a dry
+    // signal that wasn't delayed.
+    bool Init(float sample_rate, Arena& arena, float latency = 0.0f);
+
+    // in → out, n samples. in and out may alias. Pass in == nullptr to let
+    // the feedback tail ring out with no new input.
+    void ProcessBlock(const float* in, float* out, int n);
+
+    // Same, but only the wet half of the mix (0.5 · delay): for running the
+    // chorus at a lower rate while the caller adds 0.5 · dry at full rate
+    void ProcessWet(const float* in, float* out, int n);
+
+    // Zero the delay line (called when waking from bypass)
+    void Clear();
+
+private:
+    template <bool DRY>
+    void Render(const float* in, float* out, int n);
+
+    static constexpr float RATE_HZ   = 0.8f;
+    static constexpr float DEPTH     = 0.4f;
+    static constexpr float FEEDBACK  = 0.2f;
+    static constexpr float BASE_MS   = 8.0f;   // centre delay
+    static constexpr float SWING_MS  = 5.0f;   // ± swing at 100% depth
+
+    float* buf_;
+    int    mask_;        // delay line length - 1 (power of two)
+    int    write_;
+    float  lfo_phase_;   // 0–1, triangle
+    float  lfo_inc_;
+    float  base_;        // centre delay, samples
+    float  swing_;       // ± modulation, samples
+};
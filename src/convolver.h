@@ -0,0 +1,196 @@
+#pragma once
+// =============================================================================
+// convolver.h — Zero-latency uniformly partitioned FFT convolution
+// =============================================================================
+// The IR is cut into partitions of B taps. Partition 0 runs as a direct FIR
+// (B MACs per sample), so output is never delayed. Partitions 1..K run as
+// overlap-save in the frequency domain: every B input samples the newest
+// FFT_SIZE-sample window is transformed once into a frequency-domain delay
+// line, multiplied against the K partition spectra, and inverse transformed
+// into the tail that the next B outputs add to the FIR. All of that happens
+// on the sample that completes a partition; with B equal to the audio block
+// it lands once per callback.
+//
+// The signals are real, so each FFT_SIZE-point transform is a RealFft
+// (fft.h), and only the BINS non-negative frequencies are stored and
+// multiplied.
+// Cost per sample ≈ B MACs + (2 half-size FFTs + K·BINS complex MACs) / B.
+// Smaller B means a cheaper FIR but more partitions to multiply, so the
+// best B depends on the IR length (host/bench: conv_*).
+//
+// All buffers come from the arena at Init. Header-only, no Daisy
+// dependencies; the FFT tables live in the object.
+// =============================================================================
+
+#include <cmath>
+#include <cstring>
+#include "arena.h"
+#include "fft.h"
+
+// Smallest power of two holding two partitions (overlap-save window)
+constexpr int ConvFftSize(int partition) {
+    int n = 2;
+    while (n < 2 * partition) n <<= 1;
+    return n;
+}
+
+template <int B>
+class Convolver {
+    static_assert(B >= 2, "partition must be at least two samples");
+
+public:
+    static constexpr int PARTITION = B;
+    static constexpr int FFT_SIZE  = ConvFftSize(B);
+    static constexpr int HALF      = FFT_SIZE / 2;
+    static constexpr int BINS      = HALF + 1;
+
+    // Reserve buffers for IRs up to max_taps. Returns false if the arena is
+    // too small. Starts with a unit impulse (pass-through).
+    bool Init(Arena& arena, int max_taps) {
+        max_parts_ = max_taps > B ? (max_taps - 1) / B : 0;
+
+        head_  = arena.Alloc(B);
+        frame_ = arena.Alloc(FFT_SIZE);
+        tail_  = arena.Alloc(B);
+        re_    = arena.Alloc(BINS);
+        im_    = arena.Alloc(BINS);
+        size_t spectra = static_cast<size_t>(max_parts_) * BINS;
+        h_re_   = arena.Alloc(spectra);
+        h_im_   = arena.Alloc(spectra);
+        fdl_re_ = arena.Alloc(spectra);
+        fdl_im_ = arena.Alloc(spectra);
+        bool ok = head_ && frame_ && tail_ && re_ && im_ &&
+                  (max_parts_ == 0 || (h_re_ && h_im_ && fdl_re_ && fdl_im_));
+        if (!ok) {
+            max_parts_ = 0;
+            parts_ = 0;
+            return false;
+        }
+        const float unit = 1.0f;
+        SetIR(&unit, 1);
+        return true;
+    }
+
+    // Load an IR of up to max_taps (longer ones are truncated) and clear the
+    // history. FFTs every partition: call from Init, not the audio callback.
+    void SetIR(const float* ir, int taps) {
+        if (taps > (max_parts_ + 1) * B) taps = (max_parts_ + 1) * B;
+        taps_ = taps;
+        parts_ = taps > B ? (taps - 1) / B : 0;
+
+        // Partition 0, stored reversed so the FIR walks both arrays forwards
+        for (int j = 0; j < B; j++) head_[B - 1 - j] = j < taps ? ir[j] : 0.0f;
+
+        // Partition k's spectrum, with the inverse FFT's 1/HALF folded in.
+        // frame_ is free as staging: Reset() clears it below.
+        const float scale = 1.0f / static_cast<float>(HALF);
+        for (int k = 0; k < parts_; k++) {
+            for (int i = 0; i < FFT_SIZE; i++) {
+                int t = (k + 1) * B + i;
+                frame_[i] = (i < B && t < taps) ? ir[t] * scale : 0.0f;
+            }
+            rfft_.Forward(frame_, re_, im_);
+            std::memcpy(h_re_ + k * BINS, re_, BINS * sizeof(float));
+            std::memcpy(h_im_ + k * BINS, im_, BINS * sizeof(float));
+        }
+        Reset();
+    }
+
+    // Forget the input history (output restarts from silence)
+    void Reset() {
+        std::memset(frame_, 0, FFT_SIZE * sizeof(float));
+        std::memset(tail_, 0, B * sizeof(float));
+        size_t spectra = static_cast<size_t>(max_parts_) * BINS;
+        if (spectra) {
+            std::memset(fdl_re_, 0, spectra * sizeof(float));
+            std::memset(fdl_im_, 0, spectra * sizeof(float));
+        }
+        pos_ = 0;
+        fdl_head_ = 0;
+    }
+
+    // Convolve n samples in place. Any n; output is not delayed.
+    void Process(float* buf, int n) {
+        float* win = frame_ + (FFT_SIZE - B);   // newest partition
+        for (int i = 0; i < n; i++) {
+            win[pos_] = buf[i];
+            const float* x = win + pos_ - (B - 1);  // oldest input the FIR needs
+            buf[i] = tail_[pos_] + Fir(x);
+            if (++pos_ == B) {
+                pos_ = 0;
+                ProcessPartition();
+            }
+        }
+    }
+
+    int Taps() const { return taps_; }
+    int Partitions() const { return parts_ + 1; }
+
+private:
+    // Partition 0 against the last B inputs. Four partial sums so the adds
+    // pipeline instead of waiting on each other (FP adds don't reassociate).
+    float Fir(const float* x) const {
+        float a0 = 0.0f, a1 = 0.0f, a2 = 0.0f, a3 = 0.0f;
+        int j = 0;
+        for (; j + 4 <= B; j += 4) {
+            a0 += head_[j] * x[j];
+            a1 += head_[j + 1] * x[j + 1];
+            a2 += head_[j + 2] * x[j + 2];
+            a3 += head_[j + 3] * x[j + 3];
+        }
+        for (; j < B; j++) a0 += head_[j] * x[j];
+        return (a0 + a1) + (a2 + a3);
+    }
+
+    // A full partition of input has arrived: compute the tail that the
+    // next B outputs add, then slide the window by B.
+    void ProcessPartition() {
+        if (parts_ > 0) {
+            // Window spectrum into the frequency-domain delay line
+            fdl_head_ = fdl_head_ == 0 ? parts_ - 1 : fdl_head_ - 1;
+            rfft_.Forward(frame_, re_, im_);
+            std::memcpy(fdl_re_ + fdl_head_ * BINS, re_, BINS * sizeof(float));
+            std::memcpy(fdl_im_ + fdl_head_ * BINS, im_, BINS * sizeof(float));
+
+            // Partition k + 1 meets the window k partitions older
+            for (int b = 0; b < BINS; b++) re_[b] = im_[b] = 0.0f;
+            int slot = fdl_head_;
+            for (int k = 0; k < parts_; k++) {
+                const float* hr = h_re_ + k * BINS;
+                const float* hi = h_im_ + k * BINS;
+                const float* xr = fdl_re_ + slot * BINS;
+                const float* xi = fdl_im_ + slot * BINS;
+                for (int b = 0; b < BINS; b++) {
+                    re_[b] += xr[b] * hr[b] - xi[b] * hi[b];
+                    im_[b] += xr[b] * hi[b] + xi[b] * hr[b];
+                }
+                if (++slot == parts_) slot = 0;
+            }
+
+            // Back to time domain; the tail is the window's last B samples
+            rfft_.Inverse(re_, im_);
+            for (int i = 0; i < B; i++) {
+                int t = FFT_SIZE - B + i;
+                tail_[i] = (t & 1) ? im_[t >> 1] : re_[t >> 1];
+            }
+        }
+        std::memmove(frame_, frame_ + B, (FFT_SIZE - B) * sizeof(float));
+    }
+
+    RealFft<FFT_SIZE> rfft_;
+    int taps_ = 0;
+    int parts_ = 0;        // FFT partitions in use (partition 0 is the FIR)
+    int max_parts_ = 0;
+    int pos_ = 0;          // samples into the current partition
+    int fdl_head_ = 0;     // slot of the newest window spectrum
+
+    float* head_   = nullptr;   // partition 0 taps, reversed
+    float* frame_  = nullptr;   // last FFT_SIZE input samples
+    float* tail_   = nullptr;   // FFT-path output for the current partition
+    float* re_     = nullptr;   // FFT scratch, BINS each
+    float* im_     = nullptr;
+    float* h_re_   = nullptr;   // partition spectra [parts][BINS]
+    float* h_im_   = nullptr;
+    float* fdl_re_ = nullptr;   // window spectra, ring of parts
+    float* fdl_im_ = nullptr;
+};
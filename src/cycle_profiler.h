@@ -0,0 +1,199 @@
+#pragma once
+// =============================================================================
+// cycle_profiler.h — Per-stage cycle counts for the audio callback
+// =============================================================================
+// Header-only, no Daisy dependencies. Build with MS20_PROFILE=1 to enable
+// (`make PROFILE=1`, `make -C host PROFILE=1`); otherwise every scope and
+// counter compiles to nothing.
+//
+// Cycle source: DWT CYCCNT on the Cortex-M7 (core clock, 480 MHz), rdtsc on
+// x86 hosts, CLOCK_MONOTONIC ns elsewhere.
+//
+// Threading: the audio callback is the only writer (ProfileScope, EndBlock).
+// The main loop reads a consistent Snapshot through a sequence counter and
+// never blocks the callback; a reset is a request the writer applies.
+// =============================================================================
+
+#include <atomic>
+#include <cstdint>
+
+#ifndef MS20_PROFILE
+#define MS20_PROFILE 0
+#endif
+
+#if MS20_PROFILE && !defined(__arm__)
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <time.h>
+#endif
+#endif
+
+enum ProfStage {
+    PROF_VOICES,     // voice sum
+    PROF_FX_DRIVE,   // FxChain::ProcessBlock
+    PROF_FX_SPACE,   // FxChain::ProcessSpace
+    PROF_OUTPUT,     // output gain
+    PROF_CALLBACK,   // whole callback
+    PROF_NUM_STAGES
+};
+
+class CycleProfiler {
+public:
+    static constexpr bool ENABLED = MS20_PROFILE;
+
+    CycleProfiler() { ClearStats(); }
+
+    struct StageStats {
+        uint32_t min, avg, max;  // cycles per block
+    };
+    struct Snapshot {
+        StageStats stage[PROF_NUM_STAGES];
+        uint32_t blocks;         // blocks since last reset
+        uint32_t overruns;       // blocks whose callback exceeded the budget
+        uint32_t budget;         // cycles per block
+        uint64_t solves;         // Newton-Raphson filter ticks (CC 11 mode)
+        uint64_t iterations;     // and the iterations they took
+        uint32_t capped;         // solves that hit the iteration cap
+    };
+
+    // Start the cycle counter (enables DWT on the M7)
+    static void InitCounter() {
+#if MS20_PROFILE && defined(__arm__)
+        volatile uint32_t* demcr    = reinterpret_cast<volatile uint32_t*>(0xE000EDFC);
+        volatile uint32_t* dwt_lar  = reinterpret_cast<volatile uint32_t*>(0xE0001FB0);
+        volatile uint32_t* dwt_ctrl = reinterpret_cast<volatile uint32_t*>(0xE0001000);
+        volatile uint32_t* dwt_cyc  = reinterpret_cast<volatile uint32_t*>(0xE0001004);
+        *demcr |= 1u << 24;      // TRCENA
+        *dwt_lar = 0xC5ACCE55;   // unlock DWT (required on the M7)
+        *dwt_cyc = 0;
+        *dwt_ctrl |= 1u;         // CYCCNTENA
+#endif
+    }
+
+    static inline uint32_t Now() {
+#if !MS20_PROFILE
+        return 0;
+#elif defined(__arm__)
+        return *reinterpret_cast<volatile uint32_t*>(0xE0001004);
+#elif defined(__x86_64__) || defined(__i386__)
+        return static_cast<uint32_t>(__rdtsc());
+#else
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<uint32_t>(ts.tv_sec * 1000000000ull + ts.tv_nsec);
+#endif
+    }
+
+    // Cycles available per audio block (overrun threshold)
+    void SetBudget(uint32_t cycles_per_block) { budget_ = cycles_per_block; }
+
+    // --- Audio thread ---
+
+    inline void Add(int stage, uint32_t cycles) {
+        if (ENABLED) block_[stage] += cycles;
+    }
+
+    // This block's filter solves (SynthEngine::TakeFilterStats)
+    void AddSolves(uint32_t solves, uint32_t iterations, uint32_t capped) {
+        if (!ENABLED) return;
+        block_solves_ += solves;
+        block_iterations_ += iterations;
+        block_capped_ += capped;
+    }
+
+    // Fold this block's per-stage totals into the published stats
+    void EndBlock() {
+        if (!ENABLED) return;
+        if (reset_req_.load(std::memory_order_acquire)) {
+            ClearStats();
+            reset_req_.store(false, std::memory_order_relaxed);
+        }
+
+        uint32_t callback = block_[PROF_CALLBACK];
+        seq_.fetch_add(1, std::memory_order_acq_rel);  // odd: write in progress
+        for (int s = 0; s < PROF_NUM_STAGES; s++) {
+            uint32_t c = block_[s];
+            if (c < min_[s]) min_[s] = c;
+            if (c > max_[s]) max_[s] = c;
+            sum_[s] += c;
+            block_[s] = 0;
+        }
+        solves_ += block_solves_;
+        iterations_ += block_iterations_;
+        capped_ += block_capped_;
+        block_solves_ = block_iterations_ = block_capped_ = 0;
+        blocks_++;
+        if (budget_ && callback > budget_) overruns_++;
+        seq_.fetch_add(1, std::memory_order_release);  // even: consistent
+    }
+
+    // --- Main loop ---
+
+    // Copy out the stats. Returns false if the callback kept interrupting.
+    bool Read(Snapshot& out) const {
+        if (!ENABLED) return false;
+        for (int tries = 0; tries < 4; tries++) {
+            uint32_t s0 = seq_.load(std::memory_order_acquire);
+            if (s0 & 1) continue;
+            for (int s = 0; s < PROF_NUM_STAGES; s++) {
+                uint32_t n = blocks_ ? blocks_ : 1;
+                out.stage[s] = {blocks_ ? min_[s] : 0, static_cast<uint32_t>(sum_[s] / n), max_[s]};
+            }
+            out.blocks = blocks_;
+            out.overruns = overruns_;
+            out.budget = budget_;
+            out.solves = solves_;
+            out.iterations = iterations_;
+            out.capped = capped_;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq_.load(std::memory_order_relaxed) == s0) return true;
+        }
+        return false;
+    }
+
+    void RequestReset() { reset_req_.store(true, std::memory_order_release); }
+
+private:
+    void ClearStats() {
+        for (int s = 0; s < PROF_NUM_STAGES; s++) {
+            min_[s] = UINT32_MAX;
+            max_[s] = 0;
+            sum_[s] = 0;
+        }
+        blocks_ = 0;
+        overruns_ = 0;
+        solves_ = 0;
+        iterations_ = 0;
+        capped_ = 0;
+    }
+
+    uint32_t block_[PROF_NUM_STAGES] = {};
+    uint32_t min_[PROF_NUM_STAGES];     // UINT32_MAX each (ClearStats)
+    uint32_t max_[PROF_NUM_STAGES]   = {};
+    uint64_t sum_[PROF_NUM_STAGES]   = {};
+    uint32_t blocks_   = 0;
+    uint32_t overruns_ = 0;
+    uint32_t budget_   = 0;
+    uint32_t block_solves_ = 0, block_iterations_ = 0, block_capped_ = 0;
+    uint64_t solves_     = 0;
+    uint64_t iterations_ = 0;
+    uint32_t capped_     = 0;
+    std::atomic<uint32_t> seq_{0};
+    std::atomic<bool>     reset_req_{false};
+};
+
+// Adds the cycles spent in its lifetime to one stage. Empty when disabled.
+class ProfileScope {
+public:
+#if MS20_PROFILE
+    ProfileScope(CycleProfiler& p, ProfStage s) : p_(p), s_(s), t0_(CycleProfiler::Now()) {}
+    ~ProfileScope() { p_.Add(s_, CycleProfiler::Now() - t0_); }
+private:
+    CycleProfiler& p_;
+    ProfStage      s_;
+    uint32_t       t0_;
+#else
+    ProfileScope(CycleProfiler&, ProfStage) {}
+#endif
+};
@@ -0,0 +1,32 @@
+#pragma once
+// =============================================================================
+// denormals.h — Flush denormals to zero in the FPU, not in the DSP code
+// =============================================================================
+// Release tails and decaying filter, envelope and delay-line states all
+// head toward zero through the denormal range, where the host CPUs slow
+// down many times over and the M7 takes extra cycles. With flush-to-zero
+// the FPU treats denormal inputs and results as zero, so the DSP code needs
+// no per-sample flushes of its own.
+//
+//   Cortex-M7  FPSCR.FZ for the calling context, and FPDSCR.FZ: the FPSCR
+//              every interrupt handler (the audio callback) starts with
+//   x86 host   MXCSR FTZ | DAZ for the calling thread
+//
+// Call once at startup on the Seed (main.cpp), before audio starts; on the
+// host, on every thread that renders (OfflineSynth::Init does).
+// =============================================================================
+
+#include <cstdint>
+#if defined(__SSE__) || defined(__x86_64__)
+#include <xmmintrin.h>
+#endif
+
+inline void EnableFlushToZero() {
+#if defined(__arm__) && defined(__ARM_FP)
+    constexpr uint32_t FZ = 1u << 24;
+    __builtin_arm_set_fpscr(__builtin_arm_get_fpscr() | FZ);
+    *reinterpret_cast<volatile uint32_t*>(0xE000EF3Cu) |= FZ;   // FPU->FPDSCR
+#elif defined(__SSE__) || defined(__x86_64__)
+    _mm_setcsr(_mm_getcsr() | 0x8040u);   // FTZ (bit 15) | DAZ (bit 6)
+#endif
+}
@@ -0,0 +1,152 @@
+#pragma once
+// =============================================================================
+// event_loop.h — Wake-on-event main loop: event flags, deadlines, dispatch
+// =============================================================================
+// The main loop sleeps until an interrupt gives it something to do.
+// Interrupts post bits to EventFlags (MIDI bytes parsed, an OLED page
+// transfer finished, the loop timer expired, the recorder handed over a
+// buffer). The loop takes all the pending bits at once, services them,
+// and sleeps again when none are left. MIDI waits for its interrupt plus
+// at most one piece of loop work: an eye render or one page's command
+// bytes (~0.1 ms), or while recording one 8 KB SD write (a few ms). The
+// one exception is the SD card's mount when the first recording starts,
+// a single step of up to a few hundred ms. MIDI no longer waits for a
+// loop period or a blocking page transfer.
+//
+// Timed work (reading the pots, advancing the eye) is kept as deadlines on
+// one timer, armed for the earliest of them. The loop is tickless: no
+// periodic wake-up of its own. Page data goes out by DMA and its
+// completion wakes the loop to start the next page.
+//
+// EventLoop is a template over its board so the host can drive it with a
+// simulated event source (test/event_loop_test.cpp). Board provides:
+//
+//   uint32_t NowMs()                    monotonic milliseconds
+//   void     Sleep(const EventFlags&)   return once any flag is pending
+//                                       (at once if one already is)
+//   void     ArmTimer(uint32_t ms)      post EVENT_TIMER in ms, replacing
+//                                       any timer already armed
+//   void     ServiceMidi()              drain the MIDI queues
+//   void     ReadPots(float dt_s)
+//   uint32_t FramePeriodMs()            display's frame period, 0 = none
+//   bool     PrepareFrame(float dt_s)   render; false if the frame is unchanged
+//   void     StartPage(int page)        send page 0–7, post EVENT_PAGE_DONE
+//                                       when the transfer finishes
+//   bool     ServiceStorage()           one bounded piece of storage work;
+//                                       true if more is ready right away
+//   bool     ServiceBoot()              one short deferred startup stage;
+//                                       true while more remain
+//
+// Startup work the first note doesn't need (the display, the SD card) is
+// left to the loop: Init posts EVENT_BOOT and each wake runs one stage,
+// so MIDI is serviced between them from the first wake on.
+//
+// Header-only, no Daisy dependencies. Post may be called from any
+// interrupt; everything else runs on the main loop.
+// =============================================================================
+
+#include <atomic>
+#include <cstdint>
+
+enum EventBit : uint32_t {
+    EVENT_MIDI      = 1u << 0,   // UART or USB MIDI bytes parsed into the queue
+    EVENT_PAGE_DONE = 1u << 1,   // OLED page transfer complete
+    EVENT_TIMER     = 1u << 2,   // the loop timer expired
+    EVENT_STORAGE   = 1u << 3,   // the recorder handed over a buffer (recorder.h)
+    EVENT_BOOT      = 1u << 4,   // deferred startup stages remain (ServiceBoot)
+};
+
+class EventFlags {
+public:
+    void Post(uint32_t bits) { bits_.fetch_or(bits, std::memory_order_release); }
+    uint32_t Take() { return bits_.exchange(0, std::memory_order_acquire); }
+    bool Pending() const { return bits_.load(std::memory_order_relaxed) != 0; }
+
+private:
+    std::atomic<uint32_t> bits_{0};
+};
+
+template <typename Board>
+class EventLoop {
+public:
+    static constexpr uint32_t POT_PERIOD_MS = 50;   // PotFilter is tuned for 20 Hz
+    static constexpr int      NUM_PAGES     = 8;
+
+    void Init(Board& board, EventFlags& flags) {
+        board_ = &board;
+        flags_ = &flags;
+        uint32_t now = board.NowMs();
+        last_pots_ = now;
+        last_frame_ = now;
+        page_ = -1;
+        wakes_ = 0;
+        board.ReadPots(0.0f);
+        flags.Post(EVENT_BOOT);
+        Arm(now);
+    }
+
+    // Sleep until something is pending, then service it. Firmware calls
+    // this forever; the host steps it.
+    void RunOnce() {
+        board_->Sleep(*flags_);
+        uint32_t ev = flags_->Take();
+        wakes_++;
+
+        // MIDI first: everything below waits behind it, not the other way
+        if (ev & EVENT_MIDI) board_->ServiceMidi();
+        if ((ev & EVENT_PAGE_DONE) && page_ >= 0) {
+            if (++page_ < NUM_PAGES) board_->StartPage(page_);
+            else page_ = -1;
+        }
+
+        // One piece per wake, so MIDI gets in between the pieces; the loop
+        // wakes itself for the next
+        if ((ev & EVENT_STORAGE) && board_->ServiceStorage()) flags_->Post(EVENT_STORAGE);
+        if ((ev & EVENT_BOOT) && board_->ServiceBoot()) flags_->Post(EVENT_BOOT);
+
+        // Deadlines are checked on every wake, whatever woke us
+        uint32_t now = board_->NowMs();
+        if (Due(last_pots_ + POT_PERIOD_MS, now)) {
+            board_->ReadPots((now - last_pots_) * 0.001f);
+            last_pots_ = now;
+        }
+        uint32_t period = board_->FramePeriodMs();
+        if (period && page_ < 0 && Due(last_frame_ + period, now)) {
+            float dt_s = (now - last_frame_) * 0.001f;
+            last_frame_ = now;
+            if (board_->PrepareFrame(dt_s)) {
+                page_ = 0;
+                board_->StartPage(0);
+            }
+        }
+        Arm(board_->NowMs());
+    }
+
+    bool Sending() const { return page_ >= 0; }
+    uint32_t Wakes() const { return wakes_; }
+
+private:
+    // deadline reached, modulo the 49-day wrap of the ms counter
+    static bool Due(uint32_t deadline, uint32_t now) {
+        return static_cast<int32_t>(now - deadline) >= 0;
+    }
+
+    // Timer for the earliest deadline. A frame in flight has none: its
+    // last page's completion wakes the loop.
+    void Arm(uint32_t now) {
+        int32_t wait = static_cast<int32_t>(last_pots_ + POT_PERIOD_MS - now);
+        uint32_t period = board_->FramePeriodMs();
+        if (period && page_ < 0) {
+            int32_t frame = static_cast<int32_t>(last_frame_ + period - now);
+            if (frame < wait) wait = frame;
+        }
+        board_->ArmTimer(wait > 1 ? static_cast<uint32_t>(wait) : 1u);
+    }
+
+    Board*      board_;
+    EventFlags* flags_;
+    uint32_t    last_pots_;
+    uint32_t    last_frame_;    // start of the last frame check
+    int         page_;          // page in flight, −1 when idle
+    uint32_t    wakes_;
+};
@@ -28,6 +28,11 @@ void EyeRenderer::Init() {
     pupil_cx_ = EYE_CX;
     pupil_cy_ = EYE_CY;
     frame_count_ = 0;
+    anim_frames_ = 0.0f;
+    quality_ = 0;
+    frame_ = Frame();
+    drawn_valid_ = false;
+    changed_ = true;
 }
 
 void EyeRenderer::NoteOn() {
@@ -109,7 +114,7 @@ void EyeRenderer::FillSclera(float open_top, float open_bot) {
 
 // ── Blood vessels (dark lines from iris outward toward lids) ──────────────
 
-void EyeRenderer::DrawVessels(float fold, float open_top, float open_bot) {
+void EyeRenderer::DrawVessels(float fold) {
     if (fold < 0.01f) return;
 
     int count = 6 + (int)(fold * 4.0f);           // 6-10 vessels
@@ -441,12 +446,12 @@ static constexpr uint8_t FONT_ALPHA[26][3] = {
     {0x00, 0x00, 0x00},  // N
     {0x0E, 0x11, 0x0E},  // O
     {0x00, 0x00, 0x00},  // P
-    {0x00, 0x00, 0x00},  // Q
+    {0x0E, 0x11, 0x1E},  // Q
     {0x1F, 0x05, 0x1A},  // R
     {0x12, 0x15, 0x09},  // S
     {0x01, 0x1F, 0x01},  // T
     {0x00, 0x00, 0x00},  // U
-    {0x00, 0x00, 0x00},  // V
+    {0x0F, 0x10, 0x0F},  // V
     {0x00, 0x00, 0x00},  // W
     {0x1B, 0x04, 0x1B},  // X
     {0x00, 0x00, 0x00},  // Y
@@ -507,11 +512,19 @@ void EyeRenderer::DrawNumber(int x, int y, int value) {
     }
 }
 
-void EyeRenderer::DrawCCValues(const Params& p) {
+void EyeRenderer::DrawDigits(int x, int y, int value, int width) {
+    if (value < 0) value = 0;
+    // Right-aligned in `width` glyph cells, leading zeros blank
+    for (int i = width - 1; i >= 0; i--) {
+        DrawGlyph(x + i * 4, y, value % 10);
+        value /= 10;
+        if (value == 0) break;
+    }
+}
+
+void EyeRenderer::DrawCCValues(const int* cc) {
     // Top row: CCs 1-4 (cutoff, drive, sub, fold)
     // Bottom row: CCs 5-8 (decay, amp_env, filt_env, fx) + gain
-    const float top_val[4] = {p.cc_cutoff, p.cc_res, p.cc_sub, p.cc_fold};
-    const float bot_val[4] = {p.cc_decay, p.cc_amp_env, p.cc_filt_env, p.cc_fx};
     static constexpr char top_lbl[4][3] = {"CT", "RS", "SB", "FL"};
     static constexpr char bot_lbl[4][3] = {"DC", "AE", "FE", "OD"};
 
@@ -519,42 +532,95 @@ void EyeRenderer::DrawCCValues(const Params& p) {
         int x = i * 32;
         DrawChar(x,      0, top_lbl[i][0]);
         DrawChar(x + 4,  0, top_lbl[i][1]);
-        DrawNumber(x + 9, 0, (int)(top_val[i] * 127.0f));
+        DrawNumber(x + 9, 0, cc[i]);
 
         DrawChar(x,      59, bot_lbl[i][0]);
         DrawChar(x + 4,  59, bot_lbl[i][1]);
-        DrawNumber(x + 9, 59, (int)(bot_val[i] * 127.0f));
+        DrawNumber(x + 9, 59, cc[4 + i]);
     }
 
     // Output gain: bottom-right corner, above FX label
     DrawChar(109, 53, 'G');
-    DrawNumber(116, 53, (int)(p.cc_gain * 127.0f));
+    DrawNumber(116, 53, cc[8]);
+
+    // Quality governor: bottom-left corner, only while degraded
+    if (quality_ > 0) {
+        DrawChar(0, 53, 'Q');
+        DrawGlyph(4, 53, quality_);
+    }
 }
 
-// ── Main render pipeline ───────────────────────────────────────────────────
+// ── Diagnostics page ──────────────────────────────────────────────────────
 
-void EyeRenderer::Render(const Params& p) {
-    frame_count_++;
+void EyeRenderer::RenderStats(const StatRow* rows, int n) {
+    std::memset(buffer_, 0, BUF_SIZE);
+    drawn_valid_ = false;   // the eye must be drawn again after this page
+    if (n > STAT_ROWS) n = STAT_ROWS;
+    for (int r = 0; r < n; r++) {
+        int y = 1 + r * 7;   // 5 px glyphs, 2 px apart
+        DrawChar(0, y, rows[r].label[0]);
+        DrawChar(4, y, rows[r].label[1]);
+        for (int c = 0; c < 3; c++) {
+            int v = rows[r].value[c];
+            DrawDigits(14 + c * 32, y, v > 99999 ? 99999 : v, 5);
+        }
+    }
+}
 
-    // ── Ripple wave distortion ──
-    ripple_phase_ += 0.12f;
-    if (ripple_phase_ > 6.2832f) ripple_phase_ -= 6.2832f;
+// ── Output views ──────────────────────────────────────────────────────────
+// Straight to the buffer: the eye's ripple offsets don't apply here
 
-    float ripple_amp = p.cc_fx * 5.0f;
-    if (ripple_amp < 0.01f) {
-        std::memset(ripple_offsets_, 0, sizeof(ripple_offsets_));
-    } else {
-        for (int y = 0; y < H; y++) {
-            // Two sine waves at different frequencies and opposite directions
-            // for an organic, water-like shimmer
-            float wave = std::sin((float)y * 0.18f + ripple_phase_)
-                       + 0.5f * std::sin((float)y * 0.31f - ripple_phase_ * 0.7f);
-            ripple_offsets_[y] = (int)(ripple_amp * wave * 0.67f);
-        }
+void EyeRenderer::RenderSpectrum(const uint8_t* heights, int n, int marker) {
+    std::memset(buffer_, 0, BUF_SIZE);
+    drawn_valid_ = false;
+    if (n <= 0) return;
+    int bar_w = W / n;
+    int fill_w = bar_w > 1 ? bar_w - 1 : 1;   // 1 px gap between bars
+    for (int b = 0; b < n; b++) {
+        int h = heights[b] > H ? H : heights[b];
+        for (int x = b * bar_w; x < b * bar_w + fill_w; x++)
+            for (int y = H - h; y < H; y++)
+                buffer_[x + (y / 8) * W] |= (1 << (y & 7));
     }
+    if (marker >= 0 && marker < n) {
+        int x = marker * bar_w + fill_w / 2;
+        for (int y = 0; y < H; y += 2)
+            buffer_[x + (y / 8) * W] ^= (1 << (y & 7));
+    }
+}
+
+void EyeRenderer::RenderScope(const float* x, int n) {
+    std::memset(buffer_, 0, BUF_SIZE);
+    drawn_valid_ = false;
+    if (n > W) n = W;
+    int prev = -1;
+    for (int i = 0; i < n; i++) {
+        float v = x[i] < -1.0f ? -1.0f : x[i] > 1.0f ? 1.0f : x[i];
+        int y = EYE_CY - (int)(v * (H / 2 - 1));
+        // Fill the span from the previous column's point, so steep edges
+        // stay connected
+        int y0 = prev < 0 ? y : (prev < y ? prev + 1 : y);
+        int y1 = prev < 0 ? y : (prev > y ? prev - 1 : y);
+        for (int yy = y0; yy <= y1; yy++)
+            buffer_[i + (yy / 8) * W] |= (1 << (yy & 7));
+        prev = y;
+    }
+}
+
+// ── Main render pipeline ───────────────────────────────────────────────────
+
+bool EyeRenderer::Advance(const Params& p, float dt_s) {
+    float frames = dt_s * (1.0f / FRAME_S);
+    anim_frames_ += frames;
+    if (anim_frames_ > 1e5f) anim_frames_ -= 1e5f;   // keep float precision (~80 min)
+    frame_count_ = (uint32_t)anim_frames_;
+
+    // ── Ripple wave distortion ──
+    ripple_phase_ += 0.12f * frames;
+    while (ripple_phase_ > 6.2832f) ripple_phase_ -= 6.2832f;
 
     // ── Pupil wander (slow Lissajous drift) ──
-    float t = (float)frame_count_;
+    float t = anim_frames_;
     pupil_cx_ = EYE_CX + (int)(6.0f * std::sin(t * 0.03f));
     pupil_cy_ = EYE_CY + (int)(4.0f * std::sin(t * 0.019f));
 
@@ -563,40 +629,84 @@ void EyeRenderer::Render(const Params& p) {
 
     // Ray envelope: grow while gate on, decay on gate off
     if (gate_) {
-        float growth = 1.0f / (decay_time * 20.0f);
-        ray_env_ += growth;
+        ray_env_ += dt_s / decay_time;
         if (ray_env_ > 1.0f) ray_env_ = 1.0f;
     } else {
-        ray_env_ *= 0.85f;
+        ray_env_ *= std::pow(0.85f, frames);
         if (ray_env_ < 0.005f) ray_env_ = 0.0f;
     }
 
     // Lid twitch: decays naturally regardless of gate
-    float lid_decay = std::exp(-0.05f / (decay_time * 0.5f));
-    lid_env_ *= lid_decay;
+    lid_env_ *= std::exp(-dt_s / (decay_time * 0.5f));
     if (lid_env_ < 0.005f) lid_env_ = 0.0f;
 
     // ── Derive visual parameters ──
     float effective_cut = p.cc_cutoff + lid_env_ * p.cc_filt_env * (1.0f - p.cc_cutoff);
     if (effective_cut > 1.0f) effective_cut = 1.0f;
 
-    float open_top = 2.0f + effective_cut * 22.0f;
-    float open_bot = open_top;
+    frame_.pupil_cx = pupil_cx_;
+    frame_.pupil_cy = pupil_cy_;
+    frame_.pupil_r = 7 + (int)(p.cc_sub * 6.0f);
+    frame_.open_top = 2.0f + effective_cut * 22.0f;
+    frame_.ray_intensity = ray_env_ * p.cc_amp_env;
+    frame_.fold = p.cc_fold;
+    frame_.res = p.cc_res;
+    frame_.ripple_amp = p.cc_fx * 5.0f;
+    frame_.lightning = frame_.ray_intensity > 0.0f ? frame_count_ : 0;
+    const float cc[9] = {p.cc_cutoff, p.cc_res, p.cc_sub, p.cc_fold, p.cc_decay,
+                         p.cc_amp_env, p.cc_filt_env, p.cc_fx, p.cc_gain};
+    for (int i = 0; i < 9; i++) frame_.cc[i] = (int)(cc[i] * 127.0f);
+    frame_.quality = quality_;
+
+    // A visible ripple moves rows every frame; anything else is compared
+    changed_ = RippleVisible(frame_.ripple_amp) || !drawn_valid_ || !SameFrame(frame_, drawn_);
+    return changed_;
+}
+
+bool EyeRenderer::SameFrame(const Frame& a, const Frame& b) {
+    for (int i = 0; i < 9; i++)
+        if (a.cc[i] != b.cc[i]) return false;
+    return a.pupil_cx == b.pupil_cx && a.pupil_cy == b.pupil_cy && a.pupil_r == b.pupil_r
+        && a.open_top == b.open_top && a.ray_intensity == b.ray_intensity
+        && a.fold == b.fold && a.res == b.res && a.ripple_amp == b.ripple_amp
+        && a.lightning == b.lightning && a.quality == b.quality;
+}
 
-    int pupil_r = 7 + (int)(p.cc_sub * 6.0f);
-    float ray_intensity = ray_env_ * p.cc_amp_env;
+uint32_t EyeRenderer::FramePeriodMs() const {
+    bool animating = gate_ || ray_env_ > 0.0f || lid_env_ > 0.0f
+                  || RippleVisible(frame_.ripple_amp);
+    return (animating || changed_) ? ACTIVE_FRAME_MS : IDLE_FRAME_MS;
+}
+
+void EyeRenderer::Render() {
+    const Frame& f = frame_;
+
+    if (f.ripple_amp < 0.01f) {
+        std::memset(ripple_offsets_, 0, sizeof(ripple_offsets_));
+    } else {
+        for (int y = 0; y < H; y++) {
+            // Two sine waves at different frequencies and opposite directions
+            // for an organic, water-like shimmer
+            float wave = std::sin((float)y * 0.18f + ripple_phase_)
+                       + 0.5f * std::sin((float)y * 0.31f - ripple_phase_ * 0.7f);
+            ripple_offsets_[y] = (int)(f.ripple_amp * wave * 0.67f);
+        }
+    }
 
     // ── Render ──
     std::memset(buffer_, 0, BUF_SIZE);
 
-    FillSclera(open_top, open_bot);
-    DrawLimbalRing(pupil_r);
-    DrawIrisTexture(pupil_r);
-    DrawVessels(p.cc_fold, open_top, open_bot);
-    ClearPupil(pupil_r);
-    DrawCatchlight(pupil_r);
-    ClipToLids(open_top, open_bot);
-    DrawLashes(open_top, p.cc_res);
-    DrawLightning(ray_intensity);
-    DrawCCValues(p);
+    FillSclera(f.open_top, f.open_top);
+    DrawLimbalRing(f.pupil_r);
+    DrawIrisTexture(f.pupil_r);
+    DrawVessels(f.fold);
+    ClearPupil(f.pupil_r);
+    DrawCatchlight(f.pupil_r);
+    ClipToLids(f.open_top, f.open_top);
+    DrawLashes(f.open_top, f.res);
+    DrawLightning(f.ray_intensity);
+    DrawCCValues(f.cc);
+
+    drawn_ = frame_;
+    drawn_valid_ = true;
 }
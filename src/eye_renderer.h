@@ -15,10 +15,45 @@ class EyeRenderer {
 public:
     static constexpr bool ENABLED = true;  // flip to false to disable OLED
 
+    // Frame periods: while something moves (gate, rays, lid twitch,
+    // ripple, a value that just changed), and the check rate otherwise
+    static constexpr uint32_t ACTIVE_FRAME_MS = 33;
+    static constexpr uint32_t IDLE_FRAME_MS   = 100;
+
     void Init();
     void NoteOn();
     void NoteOff();
-    void Render(const Params& p);
+
+    // Move the animation on by dt_s and take the values to show from p.
+    // Returns true if Render would draw a different frame from the last
+    // one drawn; false means the display already shows it.
+    bool Advance(const Params& p, float dt_s);
+
+    // Draw the frame Advance prepared into the buffer
+    void Render();
+
+    // When to call Advance next
+    uint32_t FramePeriodMs() const;
+
+    // Quality level shown as Q1–Q4 at the left edge above the bottom row
+    // (QualityGovernor); nothing at full quality
+    void SetQuality(int level) { quality_ = level; }
+
+    // Plain text page instead of the eye (diagnostics): one row per entry,
+    // up to STAT_ROWS, 2-letter label followed by three right-aligned
+    // numbers (0–99999)
+    static constexpr int STAT_ROWS = 9;   // 7 px apart
+    struct StatRow {
+        char label[3];
+        int  value[3];
+    };
+    void RenderStats(const StatRow* rows, int n);
+
+    // Output views instead of the eye (spectrum.h): n bars of height 0–64
+    // across the width, with a dotted line over bar marker (−1 = none);
+    // or a trace of n samples in −1…+1, one per column
+    void RenderSpectrum(const uint8_t* heights, int n, int marker);
+    void RenderScope(const float* x, int n);
     const uint8_t* Buffer() const { return buffer_; }
 
 private:
@@ -42,7 +77,31 @@ private:
     float ripple_phase_;
     int   ripple_offsets_[H];  // per-row horizontal offset, precomputed each frame
     int   pupil_cx_, pupil_cy_;  // current pupil center (wanders slowly)
-    uint32_t frame_count_;
+    uint32_t frame_count_;     // whole animation frames, drives the lightning
+    float anim_frames_;        // animation clock in FRAME_S units
+    int   quality_;
+
+    // Animation speeds were tuned per frame at a fixed 20 fps; Advance
+    // scales them by dt / FRAME_S so they don't depend on the frame rate
+    static constexpr float FRAME_S = 0.05f;
+
+    // Everything that decides what a frame looks like
+    struct Frame {
+        int   pupil_cx = 0, pupil_cy = 0, pupil_r = 0;
+        float open_top = 0.0f, ray_intensity = 0.0f;
+        float fold = 0.0f, res = 0.0f, ripple_amp = 0.0f;
+        uint32_t lightning = 0;    // frame_count_ while bolts are drawn
+        int   cc[9] = {};          // values printed around the eye
+        int   quality = 0;
+    };
+    static bool SameFrame(const Frame& a, const Frame& b);
+    // Row offsets are (int)(amp · wave · 0.67) with |wave| ≤ 1.5: below
+    // this the ripple moves no pixel
+    static bool RippleVisible(float amp) { return amp * 1.5f * 0.67f >= 1.0f; }
+    Frame frame_;              // prepared by Advance
+    Frame drawn_;              // last one Render drew
+    bool  drawn_valid_;        // false until the eye is on the display
+    bool  changed_;            // last Advance returned true
 
     // --- Pixel operations (apply ripple offset, bounds-checked) ---
     void PxSet(int x, int y);
@@ -53,7 +112,7 @@ private:
 
     // --- Eye component renderers ---
     void FillSclera(float open_top, float open_bot);
-    void DrawVessels(float fold, float open_top, float open_bot);
+    void DrawVessels(float fold);
     void DrawIrisTexture(int pupil_r);
     void DrawLimbalRing(int pupil_r);
     void ClearPupil(int pupil_r);
@@ -69,7 +128,8 @@ private:
     void DrawChar(int x, int y, char ch);
     void DrawGlyph(int x, int y, int digit);
     void DrawNumber(int x, int y, int value);
-    void DrawCCValues(const Params& p);
+    void DrawDigits(int x, int y, int value, int width);
+    void DrawCCValues(const int* cc);
 
     // --- Deterministic hash for textures ---
     static uint32_t Hash(int x, int y, uint32_t seed);
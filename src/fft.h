@@ -0,0 +1,157 @@
+#pragma once
+// =============================================================================
+// fft.h — Fixed-size radix-2 complex FFT, and a real FFT on top (header-only)
+// =============================================================================
+// No Daisy dependencies, no heap, nothing to initialise: twiddles and the
+// bit-reversal table are generated at compile time, one shared constant
+// table per size (flash on the Seed), so boot computes none of them. Split
+// real/imaginary arrays, in place, unnormalised (Inverse(Forward(x)) == N·x).
+// =============================================================================
+
+#include <cstdint>
+
+// cos/sin of 2π·turns, for tables built at compile time (<cmath> isn't
+// constexpr in C++17): folded into ±½ turn, then a Taylor series in double
+constexpr double TurnCos(double turns) {
+    turns -= static_cast<double>(static_cast<long long>(turns));
+    if (turns > 0.5) turns -= 1.0;
+    if (turns < -0.5) turns += 1.0;
+    double x = 6.283185307179586 * turns, term = 1.0, sum = 1.0;
+    for (int k = 1; k < 20; k++) {
+        term *= -x * x / ((2 * k - 1) * (2 * k));
+        sum += term;
+    }
+    return sum;
+}
+constexpr double TurnSin(double turns) { return TurnCos(turns - 0.25); }
+
+template <int N>
+class Fft {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "FFT size must be a power of two");
+
+public:
+    static constexpr int SIZE = N;
+
+    void Forward(float* re, float* im) const { Transform(re, im, 1.0f); }
+    void Inverse(float* re, float* im) const { Transform(re, im, -1.0f); }
+
+private:
+    void Transform(float* re, float* im, float dir) const {
+        for (int i = 0; i < N; i++) {
+            int j = kTables.rev[i];
+            if (j > i) {
+                float t = re[i]; re[i] = re[j]; re[j] = t;
+                t = im[i]; im[i] = im[j]; im[j] = t;
+            }
+        }
+        for (int len = 2; len <= N; len <<= 1) {
+            int half = len >> 1;
+            int step = N / len;
+            for (int start = 0; start < N; start += len) {
+                for (int k = 0; k < half; k++) {
+                    float wr = kTables.cos[k * step];
+                    float wi = dir * kTables.sin[k * step];
+                    int a = start + k, b = a + half;
+                    float tr = re[b] * wr - im[b] * wi;
+                    float ti = re[b] * wi + im[b] * wr;
+                    re[b] = re[a] - tr;
+                    im[b] = im[a] - ti;
+                    re[a] += tr;
+                    im[a] += ti;
+                }
+            }
+        }
+    }
+
+    struct Tables {
+        float    cos[N / 2];   // e^(−2πi·k/N), k < N/2
+        float    sin[N / 2];
+        uint16_t rev[N];       // bit-reversed index
+    };
+    static constexpr Tables MakeTables() {
+        Tables t{};
+        for (int i = 0; i < N / 2; i++) {
+            t.cos[i] = static_cast<float>(TurnCos(-static_cast<double>(i) / N));
+            t.sin[i] = static_cast<float>(TurnSin(-static_cast<double>(i) / N));
+        }
+        for (int i = 1; i < N; i++)   // rev(i) from rev(i / 2), one bit in at the top
+            t.rev[i] = static_cast<uint16_t>((t.rev[i >> 1] >> 1) | ((i & 1) ? N / 2 : 0));
+        return t;
+    }
+    static constexpr Tables kTables = MakeTables();
+};
+
+// Real-input FFT of N samples: one N/2-point complex FFT on the even/odd
+// samples plus a twiddle pass, giving the BINS non-negative frequencies of
+// the N-point transform, unnormalised. Used by the convolver and the
+// spectrum view.
+template <int N>
+class RealFft {
+public:
+    static constexpr int SIZE = N;
+    static constexpr int HALF = N / 2;
+    static constexpr int BINS = HALF + 1;
+
+    // x[0..N) → bins 0..HALF in re/im (BINS each). Even samples go in as the
+    // real part, odd as the imaginary part; the split pass separates them:
+    //   E = (Z[k] + Z*[H−k]) / 2,  O = (Z[k] − Z*[H−k]) / 2i
+    //   X[k] = E + W^k·O,  X[H−k] = (E − W^k·O)*
+    void Forward(const float* x, float* re, float* im) const {
+        for (int i = 0; i < HALF; i++) {
+            re[i] = x[2 * i];
+            im[i] = x[2 * i + 1];
+        }
+        fft_.Forward(re, im);
+        re[HALF] = re[0];
+        im[HALF] = im[0];
+        for (int k = 0; k <= HALF / 2; k++) {
+            int j = HALF - k;
+            float zkr = re[k], zki = im[k], zjr = re[j], zji = im[j];
+            float er = 0.5f * (zkr + zjr), ei = 0.5f * (zki - zji);
+            float orr = 0.5f * (zki + zji), oi = 0.5f * (zjr - zkr);
+            float wr = kTwiddles.re[k], wi = kTwiddles.im[k];
+            float tr = wr * orr - wi * oi, ti = wr * oi + wi * orr;
+            re[k] = er + tr;
+            im[k] = ei + ti;
+            re[j] = er - tr;
+            im[j] = ti - ei;
+        }
+    }
+
+    // Bins 0..HALF in re/im → the real signal, unnormalised (×HALF), with
+    // sample 2i in re[i] and 2i+1 in im[i]. Inverse of the split pass:
+    //   E = (X[k] + X*[H−k]) / 2,  O = (X[k] − X*[H−k]) / 2 · W^−k
+    //   Z[k] = E + i·O,  Z[H−k] = E* + i·O*
+    void Inverse(float* re, float* im) const {
+        for (int k = 0; k <= HALF / 2; k++) {
+            int j = HALF - k;
+            float xkr = re[k], xki = im[k], xjr = re[j], xji = im[j];
+            float er = 0.5f * (xkr + xjr), ei = 0.5f * (xki - xji);
+            float dr = 0.5f * (xkr - xjr), di = 0.5f * (xki + xji);
+            float wr = kTwiddles.re[k], wi = -kTwiddles.im[k];
+            float orr = dr * wr - di * wi, oi = dr * wi + di * wr;
+            re[k] = er - oi;
+            im[k] = ei + orr;
+            re[j] = er + oi;
+            im[j] = orr - ei;
+        }
+        fft_.Inverse(re, im);
+    }
+
+private:
+    struct Twiddles {
+        float re[HALF];    // W^k = e^(−2πik/N)
+        float im[HALF];
+    };
+    static constexpr Twiddles MakeTwiddles() {
+        Twiddles t{};
+        for (int k = 0; k < HALF; k++) {
+            t.re[k] = static_cast<float>(TurnCos(-static_cast<double>(k) / N));
+            t.im[k] = static_cast<float>(TurnSin(-static_cast<double>(k) / N));
+        }
+        return t;
+    }
+    static constexpr Twiddles kTwiddles = MakeTwiddles();
+
+    Fft<HALF> fft_;
+};
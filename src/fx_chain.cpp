@@ -1,61 +1,480 @@
 // =============================================================================
-// fx_chain.cpp — Amp-like overdrive with pre/post filtering
+// fx_chain.cpp — Amp-like overdrive, then chorus → reverb serial crossfade
 // =============================================================================
 
 #include "fx_chain.h"
 #include <cmath>
+#include <algorithm>
+#include <cstdint>
 
-void FxChain::Init(float sample_rate) {
-    hp_pre_.Init();
-    hp_pre_.SetFilterMode(daisysp::OnePole::FILTER_MODE_HIGH_PASS);
-    hp_pre_.SetFrequency(80.f / sample_rate);
+// A sleeping-eligible stage must stay below -80 dBFS for 16 ms before it
+// is bypassed, and so must the input of a stage that is still mixed in.
+// Well above the denormal range, well below audibility.
+static constexpr float TAIL_THRESHOLD = 1e-4f;
+static constexpr float TAIL_HOLD_S    = 0.016f;
+static constexpr float SEND_FADE_S    = 0.02f;
 
-    lp_post_.Init();
-    lp_post_.SetFilterMode(daisysp::OnePole::FILTER_MODE_LOW_PASS);
-    lp_post_.SetFrequency(5000.f / sample_rate);
+// IR ↔ one-pole cabinet crossfade. The IR wakes with empty history, so a
+// one-block fade would leave the input's onset in its output as a click.
+static constexpr float CAB_FADE_S     = 0.01f;
 
+bool FxChain::Init(float sample_rate, Arena& arena, ScratchArena& scratch, int space_decimation) {
+    constexpr float pi = 3.14159265f;
+    hp_g_  = std::tan(pi * 80.f / sample_rate);
+    hp_gi_ = 1.f / (1.f + hp_g_);
+    lp_g_  = std::tan(pi * 5000.f / sample_rate);
+    lp_gi_ = 1.f / (1.f + lp_g_);
+    dc_alpha_ = 2.f * pi * 10.f / sample_rate;
+    tail_hold_samples_ = static_cast<int>(TAIL_HOLD_S * sample_rate + 0.5f);
+    cab_fade_step_ = 1.f / (CAB_FADE_S * sample_rate);
+
+    hp_state_ = 0.f;
+    lp_state_ = 0.f;
     dc_state_ = 0.f;
+    pre_gain_ = 1.f;
+    post_gain_ = 1.f;
+    drive_active_ = false;
+    drive_quiet_ = 0;
+
+    scratch_ = &scratch;
+    bool ok = scratch.Capacity() >= static_cast<size_t>(SCRATCH_FLOATS);
+
+    chorus_gate_ = {0.f, 0, false, false};
+    reverb_gate_ = {0.f, 0, false, false};
+    dry_gain_ = 1.f;
+    tail_bypass_ = false;
+    reverb_send_ = 1.f;
+
+    // The resampler's round trip comes off the chorus's centre delay, so its
+    // wet half stays aligned with the dry half. The reverb's first echo is
+    // 30+ ms out; a millisecond or two of extra pre-delay doesn't matter.
+    space_rs_.Init(space_decimation);
+    space_idle_ = true;
+    int r = space_rs_.Factor();
+    float low_rate = sample_rate / static_cast<float>(r);
+    float rs_latency = static_cast<float>(space_rs_.Latency()) / static_cast<float>(r);
+    send_step_ = 1.f / (SEND_FADE_S * low_rate);
+    ok = chorus_.Init(low_rate, arena, rs_latency) && ok;
+    ok = reverb_.Init(low_rate, arena) && ok;
+
+    cab_ir_gain_ = 0.f;
+    cab_ready_ = cab_.Init(arena, CAB_IR_TAPS);
+    float* ir = cab_ready_ ? arena.Alloc(CAB_IR_TAPS) : nullptr;
+    if (ir) {
+        BuildCabinetIR(ir, CAB_IR_TAPS, sample_rate);
+        cab_.SetIR(ir, CAB_IR_TAPS);
+    }
+    cab_ready_ = ir != nullptr;
+    return ok && cab_ready_;
+}
+
+// ---------------------------------------------------------------------------
+// Built-in cabinet IR
+// ---------------------------------------------------------------------------
+
+// RBJ cookbook biquad, run in place over x (Direct Form I)
+static void Biquad(float* x, int n, float b0, float b1, float b2, float a0, float a1, float a2) {
+    float x1 = 0.f, x2 = 0.f, y1 = 0.f, y2 = 0.f;
+    float inv_a0 = 1.f / a0;
+    for (int i = 0; i < n; i++) {
+        float y = (b0 * x[i] + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2) * inv_a0;
+        x2 = x1; x1 = x[i];
+        y2 = y1; y1 = y;
+        x[i] = y;
+    }
+}
+
+static void BiquadLowpass(float* x, int n, float sr, float f, float q) {
+    float w = 2.f * 3.14159265f * f / sr, c = std::cos(w), al = std::sin(w) / (2.f * q);
+    Biquad(x, n, (1.f - c) / 2.f, 1.f - c, (1.f - c) / 2.f, 1.f + al, -2.f * c, 1.f - al);
+}
+
+static void BiquadHighpass(float* x, int n, float sr, float f, float q) {
+    float w = 2.f * 3.14159265f * f / sr, c = std::cos(w), al = std::sin(w) / (2.f * q);
+    Biquad(x, n, (1.f + c) / 2.f, -(1.f + c), (1.f + c) / 2.f, 1.f + al, -2.f * c, 1.f - al);
+}
+
+static void BiquadPeak(float* x, int n, float sr, float f, float q, float db) {
+    float A = std::pow(10.f, db / 40.f);
+    float w = 2.f * 3.14159265f * f / sr, c = std::cos(w), al = std::sin(w) / (2.f * q);
+    Biquad(x, n, 1.f + al * A, -2.f * c, 1.f - al * A, 1.f + al / A, -2.f * c, 1.f - al / A);
+}
+
+// A close-miked closed-back 2x12: thump around 110 Hz, a scooped low-mid,
+// speaker presence near 2.5 kHz and a steep cone roll-off above 5 kHz,
+// plus two early reflections off the cabinet walls and a faint, fast-
+// decaying room tail. Normalised to unity gain at 1 kHz like the one-pole
+// it replaces, and faded out over its last quarter.
+void FxChain::BuildCabinetIR(float* ir, int taps, float sample_rate) {
+    for (int i = 0; i < taps; i++) ir[i] = 0.f;
+    auto tap = [&](float seconds, float gain) {
+        int i = static_cast<int>(seconds * sample_rate);
+        if (i < taps) ir[i] += gain;
+    };
+    tap(0.0f, 1.f);
+    tap(0.0011f, 0.35f);
+    tap(0.0026f, -0.2f);
+
+    // Built at boot, so no libm per tap: the decay, the fade-out and the
+    // 1 kHz phasor below are recurrences
+    uint32_t rng = 0x1234567u;
+    float decay = 0.02f, decay_step = std::exp(-1.f / (0.008f * sample_rate));
+    for (int i = 0; i < taps; i++) {
+        rng = rng * 1664525u + 1013904223u;
+        float noise = static_cast<float>(static_cast<int32_t>(rng)) * (1.f / 2147483648.f);
+        ir[i] += noise * decay;
+        decay *= decay_step;
+    }
+
+    BiquadHighpass(ir, taps, sample_rate, 90.f, 0.7f);
+    BiquadPeak(ir, taps, sample_rate, 110.f, 1.2f, 5.f);
+    BiquadPeak(ir, taps, sample_rate, 550.f, 1.0f, -4.f);
+    BiquadPeak(ir, taps, sample_rate, 2500.f, 2.0f, 5.f);
+    BiquadLowpass(ir, taps, sample_rate, 5000.f, 0.9f);
+    BiquadLowpass(ir, taps, sample_rate, 5000.f, 0.6f);
+
+    int fade = taps / 4;
+    double fw = 3.14159265358979 / fade, f_re = 1.0, f_im = 0.0;   // cos(π·i/fade)
+    double frot_re = std::cos(fw), frot_im = std::sin(fw);
+    for (int i = 0; i < fade; i++) {
+        ir[taps - 1 - i] *= static_cast<float>(0.5 - 0.5 * f_re);
+        double t = f_re * frot_re - f_im * frot_im;
+        f_im = f_re * frot_im + f_im * frot_re;
+        f_re = t;
+    }
+
+    // Unity at 1 kHz: e^(−iωn) by rotation, in double so it doesn't drift
+    double re = 0.0, im = 0.0;
+    double w = -2.0 * 3.14159265358979 * 1000.0 / sample_rate;
+    double rot_re = std::cos(w), rot_im = std::sin(w), ph_re = 1.0, ph_im = 0.0;
+    for (int i = 0; i < taps; i++) {
+        re += ir[i] * ph_re;
+        im += ir[i] * ph_im;
+        double t = ph_re * rot_re - ph_im * rot_im;
+        ph_im = ph_re * rot_im + ph_im * rot_re;
+        ph_re = t;
+    }
+    float norm = static_cast<float>(1.0 / std::sqrt(re * re + im * im));
+    for (int i = 0; i < taps; i++) ir[i] *= norm;
+}
+
+float FxChain::FastTanh(float x) {
+    // Lambert continued fraction, 7th order: < 1e-4 error up to |x| = 4.97,
+    // where it meets ±1. Clamped input keeps it branch-free.
+    x = std::fmax(-4.97f, std::fmin(4.97f, x));
+    float x2 = x * x;
+    float num = x * (135135.f + x2 * (17325.f + x2 * (378.f + x2)));
+    float den = 135135.f + x2 * (62370.f + x2 * (3150.f + x2 * 28.f));
+    return num / den;
 }
 
 float FxChain::AsymClip(float x) {
     // Positive: gentle saturation; Negative: harder clip at half amplitude
-    // Both branches pass through origin → continuous at x=0
-    return (x >= 0.f) ? tanhf(x) : tanhf(2.f * x) * 0.5f;
+    // Both branches pass through origin → continuous at x=0. Written as
+    // selects around one tanh so the loop stays branch-free.
+    bool pos = x >= 0.f;
+    float k = pos ? 1.f : 2.f;
+    float s = pos ? 1.f : 0.5f;
+    return FastTanh(k * x) * s;
 }
 
-float FxChain::FlushDenormal(float x) {
-    // Force subnormal floats to zero — prevents CPU stalls on ARM
-    union { float f; uint32_t i; } u = {x};
-    return (u.i & 0x7F800000) ? x : 0.f;
+void FxChain::ProcessBlock(float* buf, int n, float drive, bool cab_ir) {
+    while (n > 0) {
+        int chunk = n < MAX_BLOCK ? n : MAX_BLOCK;
+        ProcessDriveChunk(buf, chunk, drive, cab_ir);
+        buf += chunk;
+        n -= chunk;
+    }
 }
 
-float FxChain::Process(float in, float drive) {
-    if (drive < 0.001f) {
-        return in;
+float FxChain::Peak(const float* x, int n) {
+    float peak = 0.f;
+    for (int i = 0; i < n; i++) peak = std::max(peak, std::fabs(x[i]));
+    return peak;
+}
+
+void FxChain::ProcessDriveChunk(float* buf, int n, float drive, bool cab_ir) {
+    bool active = drive >= 0.001f;
+
+    // Silence puts the stage to sleep the same way a bypass does: the
+    // quiet input passes dry, and the next sound enters with clean state
+    bool quiet_in = active && Peak(buf, n) < TAIL_THRESHOLD;
+    if (!quiet_in) drive_quiet_ = 0;
+    else if (drive_quiet_ >= tail_hold_samples_) active = false;
+
+    // Bypass fast path: no filter or gain state touched
+    if (!active && !drive_active_) return;
+
+    // IR cabinet runs while on or fading out; it wakes with fresh history
+    bool ir = cab_ir && cab_ready_;
+    bool ir_run = ir || cab_ir_gain_ > 0.f;
+    bool entering = active && !drive_active_;
+    if (ir_run && (entering || cab_ir_gain_ == 0.f)) cab_.Reset();
+
+    // Entering the stage starts from clean filter state
+    if (entering) {
+        hp_state_ = 0.f;
+        lp_state_ = 0.f;
+        dc_state_ = 0.f;
     }
 
-    // Pre HPF — coupling cap removes sub-bass before clipping
-    float sig = hp_pre_.Process(in);
+    // Gain stage — quadratic curve for fine control at low drive.
+    // Output gain compensation keeps loudness consistent across drive.
+    // Leaving the stage keeps the last gains for the fade-out block.
+    float pre_t  = active ? 1.f + drive * drive * 39.f : pre_gain_;
+    float post_t = active ? 0.5f / FastTanh(0.5f * pre_t) : post_gain_;
 
-    // Gain stage — quadratic curve for fine control at low drive
-    float pre_gain = 1.f + drive * drive * 39.f;
-    sig *= pre_gain;
+    // Dry/wet crossfade only on the block that crosses the threshold
+    float inv_n = 1.f / static_cast<float>(n);
+    float wet0  = drive_active_ ? 1.f : 0.f;
+    float dwet  = ((active ? 1.f : 0.f) - wet0) * inv_n;
+    float pre   = pre_gain_,  dpre  = (pre_t - pre_gain_) * inv_n;
+    float post  = post_gain_, dpost = (post_t - post_gain_) * inv_n;
 
-    // Asymmetric soft clip — even harmonics for tube warmth
-    sig = AsymClip(sig);
+    ScratchFrame frame(*scratch_);
+    float* cab_in = ir_run ? frame.Take(n) : nullptr;   // clipper output, convolved in place
+    float* cab_lp = ir_run ? frame.Take(n) : nullptr;   // one-pole output, for the crossfade
+
+    float hp_s = hp_state_, lp_s = lp_state_, dc_s = dc_state_;
+    for (int i = 0; i < n; i++) {
+        float fi = static_cast<float>(i + 1);
+        float in = buf[i];
+
+        // Pre HPF — coupling cap removes sub-bass before clipping
+        float hp_lp = (hp_g_ * in + hp_s) * hp_gi_;
+        hp_s = hp_g_ * (in - hp_lp) + hp_lp;
+        float sig = in - hp_lp;
+
+        // Asymmetric soft clip — even harmonics for tube warmth
+        sig = AsymClip(sig * (pre + dpre * fi)) * (post + dpost * fi);
+
+        // DC blocker (~10 Hz) — removes offset from asymmetric clipping
+        dc_s += dc_alpha_ * (sig - dc_s);
+        sig -= dc_s;
+
+        // Post LPF — cabinet sim softens harsh upper harmonics
+        float lp = (lp_g_ * sig + lp_s) * lp_gi_;
+        lp_s = lp_g_ * (sig - lp) + lp;
+
+        if (ir_run) {
+            cab_in[i] = sig;
+            cab_lp[i] = lp;
+            continue;
+        }
+        float wet = wet0 + dwet * fi;
+        buf[i] = in + wet * (lp - in);
+    }
+
+    if (ir_run) {
+        cab_.Process(cab_in, n);
+        float g0 = cab_ir_gain_, fade = cab_fade_step_ * static_cast<float>(n);
+        float ir_t = ir ? std::min(1.f, g0 + fade) : std::max(0.f, g0 - fade);
+        float dg = (ir_t - g0) * inv_n;
+        for (int i = 0; i < n; i++) {
+            float fi = static_cast<float>(i + 1);
+            float cab = cab_lp[i] + (g0 + dg * fi) * (cab_in[i] - cab_lp[i]);
+            float wet = wet0 + dwet * fi;
+            buf[i] += wet * (cab - buf[i]);
+        }
+        cab_ir_gain_ = ir_t;
+    }
+
+    hp_state_ = hp_s;
+    lp_state_ = lp_s;
+    dc_state_ = dc_s;
+    if (quiet_in && active)
+        drive_quiet_ = Peak(buf, n) < TAIL_THRESHOLD ? drive_quiet_ + n : 0;
+    pre_gain_ = pre_t;
+    post_gain_ = post_t;
+    drive_active_ = active;
+}
 
-    // Output gain compensation — keep loudness consistent across drive range
-    float post_gain = 0.5f / tanhf(0.5f * pre_gain);
-    sig *= post_gain;
+// ---------------------------------------------------------------------------
+// Chorus → reverb crossfade
+// ---------------------------------------------------------------------------
 
-    // DC blocker (~10 Hz) — removes offset from asymmetric clipping
-    constexpr float dc_alpha = 2.f * 3.14159265f * 10.f / 48000.f;
-    dc_state_ += dc_alpha * (sig - dc_state_);
-    sig -= dc_state_;
-    sig = FlushDenormal(sig);
+// SPEC §6.3: 0–50% dry→chorus, 50–100% chorus→reverb, linear in each half
+static void SpaceWeights(float mix, float& dry, float& chorus, float& reverb) {
+    if (mix <= 0.5f) {
+        dry    = 1.f - 2.f * mix;
+        chorus = 2.f * mix;
+        reverb = 0.f;
+    } else {
+        dry    = 0.f;
+        chorus = 2.f - 2.f * mix;
+        reverb = 2.f * mix - 1.f;
+    }
+}
+
+bool FxChain::Wake(StageGate& g, float target, bool quiet_in) {
+    if (target > 0.f && !quiet_in && !g.awake) {
+        g.awake = true;
+        g.quiet_samples = 0;
+        return true;
+    }
+    return false;
+}
+
+void FxChain::Settle(StageGate& g, float target, bool quiet_in, const float* out, int n,
+                     int span) const {
+    g.gain = target;
+    if (!g.awake) return;
+    if (target > 0.f && !quiet_in) {
+        g.quiet_samples = 0;
+        return;
+    }
+    if (target == 0.f && tail_bypass_) {
+        g.awake = false;
+        g.stale = true;
+        return;
+    }
+
+    g.quiet_samples = (Peak(out, n) < TAIL_THRESHOLD) ? g.quiet_samples + span : 0;
+    if (g.quiet_samples >= tail_hold_samples_) g.awake = false;
+}
+
+const float* FxChain::ReverbSend(const float* in, float* ramp, int n) {
+    if (reverb_send_ >= 1.f) return in;
+    for (int i = 0; i < n; i++) {
+        reverb_send_ = std::min(1.f, reverb_send_ + send_step_);
+        ramp[i] = in[i] * reverb_send_;
+    }
+    return ramp;
+}
+
+void FxChain::ProcessSpace(float* buf, int n, float mix) {
+    while (n > 0) {
+        int chunk = n < MAX_BLOCK ? n : MAX_BLOCK;
+        ProcessSpaceChunk(buf, chunk, mix);
+        buf += chunk;
+        n -= chunk;
+    }
+}
+
+void FxChain::ProcessSpaceChunk(float* buf, int n, float mix) {
+    float dry_t, chorus_t, reverb_t;
+    SpaceWeights(mix, dry_t, chorus_t, reverb_t);
+
+    // Both stages asleep and staying so (fully dry, or nothing to feed
+    // them), dry gain steady: at most the dry gain to apply
+    bool quiet_in = Peak(buf, n) < TAIL_THRESHOLD;
+    if (!chorus_gate_.awake && !reverb_gate_.awake && dry_t == dry_gain_ &&
+        (quiet_in || (chorus_t == 0.f && reverb_t == 0.f))) {
+        if (dry_t != 1.f)
+            for (int i = 0; i < n; i++) buf[i] *= dry_t;
+        chorus_gate_.gain = chorus_t;
+        reverb_gate_.gain = reverb_t;
+        space_idle_ = true;
+        return;
+    }
+
+    // A stage waking from sleep gets a clean chorus line; the reverb only
+    // sleeps once its lines are below threshold, so it needs no clearing
+    // unless the tail bypass cut it short.
+    if (Wake(chorus_gate_, chorus_t, quiet_in)) chorus_.Clear();
+    if (Wake(reverb_gate_, reverb_t, quiet_in) && reverb_gate_.stale) {
+        reverb_.Clear();
+        reverb_gate_.stale = false;
+        reverb_send_ = 0.f;
+    }
+
+    if (space_rs_.Factor() > 1) {
+        ProcessSpaceDecimated(buf, n, dry_t, chorus_t, reverb_t, quiet_in);
+        return;
+    }
+
+    ScratchFrame frame(*scratch_);
+    float* chorus_buf = frame.Take(n);
+    float* reverb_buf = frame.Take(n);
+
+    // Stages with zero weight (start and end of block) get no new input,
+    // so their tails decay toward sleep
+    if (chorus_gate_.awake) {
+        bool feed = chorus_t > 0.f || chorus_gate_.gain > 0.f;
+        chorus_.ProcessBlock(feed ? buf : nullptr, chorus_buf, n);
+    }
+    if (reverb_gate_.awake) {
+        bool feed = reverb_t > 0.f || reverb_gate_.gain > 0.f;
+        reverb_.ProcessBlock(feed ? ReverbSend(buf, reverb_buf, n) : nullptr, reverb_buf, n);
+    }
+
+    // Linear gain ramps across the block — CC steps never zipper
+    float inv_n = 1.f / static_cast<float>(n);
+    float d0 = dry_gain_, dd = (dry_t - d0) * inv_n;
+    for (int i = 0; i < n; i++)
+        buf[i] *= d0 + dd * static_cast<float>(i + 1);
+
+    if (chorus_gate_.awake) {
+        float c0 = chorus_gate_.gain, dc = (chorus_t - c0) * inv_n;
+        for (int i = 0; i < n; i++)
+            buf[i] += (c0 + dc * static_cast<float>(i + 1)) * chorus_buf[i];
+        Settle(chorus_gate_, chorus_t, quiet_in, chorus_buf, n, n);
+    }
+    if (reverb_gate_.awake) {
+        float r0 = reverb_gate_.gain, dr = (reverb_t - r0) * inv_n;
+        for (int i = 0; i < n; i++)
+            buf[i] += (r0 + dr * static_cast<float>(i + 1)) * reverb_buf[i];
+        Settle(reverb_gate_, reverb_t, quiet_in, reverb_buf, n, n);
+    }
+
+    dry_gain_ = dry_t;
+}
+
+// Same mix with chorus and reverb at 1/R rate: the send is decimated, both
+// stages run on the short block, their gain-weighted sum is interpolated
+// back. The chorus's 0.5 · dry joins the dry gain at full rate.
+void FxChain::ProcessSpaceDecimated(float* buf, int n, float dry_t, float chorus_t,
+                                    float reverb_t, bool quiet_in) {
+    // Waking from the fast path: the filters still hold the old send
+    if (space_idle_) {
+        space_rs_.Reset();
+        space_idle_ = false;
+    }
+
+    ScratchFrame frame(*scratch_);
+    float* send_low   = frame.Take(n);   // decimated send
+    float* wet_low    = frame.Take(n);   // gain-weighted chorus + reverb, low rate
+    float* chorus_buf = frame.Take(n);
+    float* reverb_buf = frame.Take(n);
+
+    int m = space_rs_.Down(buf, n, send_low);
+
+    if (chorus_gate_.awake) {
+        bool feed = chorus_t > 0.f || chorus_gate_.gain > 0.f;
+        chorus_.ProcessWet(feed ? send_low : nullptr, chorus_buf, m);
+    }
+    if (reverb_gate_.awake) {
+        bool feed = reverb_t > 0.f || reverb_gate_.gain > 0.f;
+        reverb_.ProcessBlock(feed ? ReverbSend(send_low, reverb_buf, m) : nullptr, reverb_buf, m);
+    }
+
+    // The chorus's own dry half joins the dry gain at the audio rate
+    float inv_n = 1.f / static_cast<float>(n);
+    float c0 = chorus_gate_.awake ? chorus_gate_.gain : 0.f;
+    float c1 = chorus_gate_.awake ? chorus_t : 0.f;
+    float d0 = dry_gain_ + 0.5f * c0;
+    float dd = (dry_t + 0.5f * c1 - d0) * inv_n;
+
+    // Wet gains ramp at the low rate, ahead of the interpolator
+    float inv_m = m > 0 ? 1.f / static_cast<float>(m) : 0.f;
+    for (int i = 0; i < m; i++) wet_low[i] = 0.f;
+    if (chorus_gate_.awake) {
+        float dc = (chorus_t - c0) * inv_m;
+        for (int i = 0; i < m; i++)
+            wet_low[i] += (c0 + dc * static_cast<float>(i + 1)) * chorus_buf[i];
+        Settle(chorus_gate_, chorus_t, quiet_in, chorus_buf, m, n);
+    }
+    if (reverb_gate_.awake) {
+        float r0 = reverb_gate_.gain, dr = (reverb_t - r0) * inv_m;
+        for (int i = 0; i < m; i++)
+            wet_low[i] += (r0 + dr * static_cast<float>(i + 1)) * reverb_buf[i];
+        Settle(reverb_gate_, reverb_t, quiet_in, reverb_buf, m, n);
+    }
 
-    // Post LPF — cabinet sim softens harsh upper harmonics
-    sig = lp_post_.Process(sig);
+    // reverb_buf is done with: it takes the interpolated wet sum
+    space_rs_.Up(wet_low, m, reverb_buf, n);
+    for (int i = 0; i < n; i++)
+        buf[i] = buf[i] * (d0 + dd * static_cast<float>(i + 1)) + reverb_buf[i];
 
-    return sig;
+    dry_gain_ = dry_t;
 }
@@ -1,22 +1,127 @@
 #pragma once
 // =============================================================================
-// fx_chain.h — Amp-like overdrive with pre/post filtering
+// fx_chain.h — Amp-like overdrive, then chorus → reverb serial crossfade
 // =============================================================================
 
-#include "daisysp.h"
+#include "arena.h"
+#include "audio_config.h"
+#include "chorus.h"
+#include "convolver.h"
+#include "resampler.h"
+#include "reverb.h"
 
 class FxChain {
 public:
-    void Init(float sample_rate);
+    // Largest block ProcessSpace handles in one pass (longer blocks are split)
+    static constexpr int MAX_BLOCK = 256;
 
-    // Process one sample with overdrive amount (0–1)
-    float Process(float in, float drive);
+    // Cabinet IR: partitions match the audio block so the FFT work lands
+    // once per callback (floored at 32 — tiny partitions spend more on
+    // spectra than they save on the FIR). Longest IR SetCabinetIR takes.
+    static constexpr int CAB_PARTITION = AUDIO_BLOCK_SIZE < 32 ? 32
+                                       : AUDIO_BLOCK_SIZE > 128 ? 128 : AUDIO_BLOCK_SIZE;
+    static constexpr int CAB_IR_TAPS = 2048;
+
+    // Scratch a ProcessBlock/ProcessSpace call borrows at most (four
+    // MAX_BLOCK buffers for the decimated chorus/reverb)
+    static constexpr int SCRATCH_FLOATS = 4 * MAX_BLOCK;
+
+    // Delay lines for chorus and reverb and the cabinet convolver's buffers
+    // are taken from the arena, per-block temporaries from scratch. Returns
+    // false if either is too small. Chorus and reverb run at sample_rate /
+    // space_decimation (1, 2 or 4), which shrinks their delay lines and CPU
+    // by the same factor.
+    bool Init(float sample_rate, Arena& arena, ScratchArena& scratch,
+              int space_decimation = FX_DECIMATION);
+
+    // Overdrive a block in place with amount drive (0–1). Gains are
+    // computed once per block and ramped when drive changes; below 0.001
+    // the stage is bypassed (crossfaded over one block, no state updates).
+    // It also sleeps as if bypassed once its input and output have been
+    // silent for a while, and wakes with clean state on the next sound.
+    // cab_ir swaps the one-pole cabinet for the convolution cabinet
+    // (crossfaded over 10 ms).
+    void ProcessBlock(float* buf, int n, float drive, bool cab_ir = false);
+
+    // Replace the built-in cabinet IR (up to CAB_IR_TAPS, at the Init
+    // sample rate). Not real-time safe.
+    void SetCabinetIR(const float* ir, int taps) { cab_.SetIR(ir, taps); }
+
+    // Chorus/reverb crossfade (SPEC §6.3) over a block, in place.
+    // mix: 0 = dry, 0.5 = chorus, 1 = reverb. A stage whose weight is zero
+    // stops receiving input and goes to sleep once its tail has decayed;
+    // so does one whose input has gone silent. It wakes when its weight
+    // and its input come back.
+    void ProcessSpace(float* buf, int n, float mix);
+
+    int SpaceDecimation() const { return space_rs_.Factor(); }
+
+    // On: a stage whose weight reaches zero sleeps at once instead of
+    // running its (already inaudible) tail down, and is cleared when it
+    // next wakes, the reverb's send fading in over SEND_FADE_S so its
+    // first echoes don't start with a step (QUALITY_LEAN_FX)
+    void SetTailBypass(bool on) { tail_bypass_ = on; }
+
+    bool ChorusAwake() const { return chorus_gate_.awake; }
+    bool ReverbAwake() const { return reverb_gate_.awake; }
+    bool DriveAwake() const { return drive_active_; }
 
 private:
     static float AsymClip(float x);
-    static float FlushDenormal(float x);
+    static float FastTanh(float x);
+
+    // Per-stage wet gain ramp and tail-decay bookkeeping
+    struct StageGate {
+        float gain;         // wet gain at the end of the last block
+        int   quiet_samples; // consecutive silent samples with gain == 0 or no input
+        bool  awake;
+        bool  stale;        // put to sleep with a tail still in its lines
+    };
+    // Returns true if the stage must run this block
+    static bool Wake(StageGate& g, float target, bool quiet_in);
+    // out holds n wet samples covering span samples of audio-rate time
+    void Settle(StageGate& g, float target, bool quiet_in, const float* out, int n,
+                int span) const;
+    static float Peak(const float* x, int n);
+
+    // Reverb input: in, or a copy in ramp faded in after a cleared wake
+    const float* ReverbSend(const float* in, float* ramp, int n);
+
+    void ProcessDriveChunk(float* buf, int n, float drive, bool cab_ir);
+    void ProcessSpaceChunk(float* buf, int n, float mix);
+    void ProcessSpaceDecimated(float* buf, int n, float dry_t, float chorus_t, float reverb_t,
+                               bool quiet_in);
+    static void BuildCabinetIR(float* ir, int taps, float sample_rate);
+
+    // Overdrive: TPT one-poles (g = tan(πf/sr), gi = 1/(1+g))
+    float hp_g_, hp_gi_, hp_state_;  // 80 Hz coupling cap (high-pass)
+    float lp_g_, lp_gi_, lp_state_;  // 5 kHz cabinet sim (low-pass)
+    float dc_alpha_;                 // DC blocker coefficient (~10 Hz)
+    float dc_state_;                 // DC blocker accumulator
+    int   tail_hold_samples_;        // quiet time before a stage sleeps
+    float pre_gain_;                 // gains at the end of the last block
+    float post_gain_;
+    bool  drive_active_;             // false = bypassed or asleep
+    int   drive_quiet_;              // consecutive silent samples in and out
+
+    Convolver<CAB_PARTITION> cab_;   // IR cabinet, replaces lp_* when on
+    bool  cab_ready_;                // false if the arena couldn't hold it
+    float cab_ir_gain_;              // IR vs one-pole at the end of the last block
+    float cab_fade_step_;            // crossfade per sample
+
+    Chorus    chorus_;
+    Reverb    reverb_;
+    StageGate chorus_gate_;
+    StageGate reverb_gate_;
+    float     dry_gain_;
+    bool      tail_bypass_;
+    float     reverb_send_;           // < 1 while fading in after a cleared wake
+    float     send_step_;             // per reverb-rate sample
+
+    // Decimated chorus/reverb (space_rs_.Factor() > 1). The chorus's dry
+    // half stays at the audio rate; only the wet sum takes the round trip.
+    FxResampler space_rs_;
+    bool      space_idle_;             // fast path ran: resampler state is stale
 
-    daisysp::OnePole hp_pre_;   // 80 Hz coupling cap
-    daisysp::OnePole lp_post_;  // 5 kHz cabinet sim
-    float dc_state_;            // DC blocker accumulator
+    ScratchArena* scratch_;            // per-call temporaries (SCRATCH_FLOATS)
 };
@@ -2,19 +2,31 @@
 // main.cpp — DaisyMS20 Prototype
 // =============================================================================
 // 4-voice polyphonic MS-20 filter synth. MIDI in via USB and UART (D14).
-// Audio out on pin 18. 8 MIDI CCs control everything. See README.md.
+// Audio out on pin 18. MIDI CCs 1–13 (sound), 20–28 (modulation) and
+// 117–119 (display, recording, diagnostics). See README.md.
 // =============================================================================
 
+#include <algorithm>
 #include <cmath>
+#include <cstdio>
 #include <cstring>
 #include "daisy_seed.h"
 #include "daisysp.h"
-#include "voice.h"
-#include "fx_chain.h"
+#include "fatfs.h"
+#include "synth_engine.h"
 #include "params.h"
 #include "eye_renderer.h"
 #include "adc_pots.h"
-#include "voice_allocator.h"
+#include "arena.h"
+#include "cycle_profiler.h"
+#include "quality_governor.h"
+#include "event_loop.h"
+#include "recorder.h"
+#include "capture_ring.h"
+#include "spectrum.h"
+#include "audio_config.h"
+#include "denormals.h"
+#include "boot_profile.h"
 
 using namespace daisy;
 
@@ -22,198 +34,542 @@ using namespace daisy;
 // Global objects
 // ---------------------------------------------------------------------------
 static DaisySeed hw;
-static MidiUartHandler midi_uart;
-static MidiUsbHandler  midi_usb;
-static constexpr int NUM_VOICES = 4;
-static Voice voices[NUM_VOICES];
-static VoiceAllocator<NUM_VOICES> allocator;
-static Params params;
+static SynthEngine engine;
 
-static FxChain fx;
+// Set by interrupts, taken by the main loop (event_loop.h)
+static EventFlags events;
+
+// A MIDI transport that also wakes the main loop: the parse callback runs
+// in the UART/USB receive interrupt, after it has queued the events
+template <typename Transport>
+class WakingTransport {
+public:
+    using Config = typename Transport::Config;
+
+    void Init(Config config) { transport_.Init(config); }
+    void StartRx(MidiRxParseCallback callback, void* context) {
+        parse_ = callback;
+        parse_context_ = context;
+        transport_.StartRx(Received, this);
+    }
+    bool RxActive() { return transport_.RxActive(); }
+    void FlushRx() { transport_.FlushRx(); }
+    void Tx(uint8_t* buffer, size_t size) { transport_.Tx(buffer, size); }
+
+private:
+    static void Received(uint8_t* data, size_t size, void* context) {
+        auto* self = static_cast<WakingTransport*>(context);
+        self->parse_(data, size, self->parse_context_);
+        events.Post(EVENT_MIDI);
+    }
+
+    Transport           transport_;
+    MidiRxParseCallback parse_;
+    void*               parse_context_;
+};
+
+using MidiUart = MidiHandler<WakingTransport<MidiUartTransport>>;
+using MidiUsb  = MidiHandler<WakingTransport<MidiUsbTransport>>;
+static MidiUart midi_uart;
+static MidiUsb  midi_usb;
+
+// Loop timer: TIM5 (TIM2 is the system tick), one-shot in effect since the
+// loop re-arms it on every wake
+static TimerHandle loop_timer;
+static uint32_t    loop_timer_ticks_per_ms;
+
+// Chorus + reverb delay lines live in external SDRAM (~90 KB used at 48 kHz)
+static constexpr size_t FX_ARENA_FLOATS = 64 * 1024;  // 256 KB
+static float DSY_SDRAM_BSS fx_arena_mem[FX_ARENA_FLOATS];
+static Arena fx_arena;
+
+// The engine renders straight into the codec buffers (audio_config.h)
+static_assert(AUDIO_MAX_BLOCK <= FxChain::MAX_BLOCK, "FX chunking must cover any block");
 
 // Eye display
 static EyeRenderer eye;
 static I2CHandle   oled_i2c;
 static constexpr uint8_t OLED_ADDR = 0x3C;
 
+// Output views (CC 117): the audio callback feeds the capture ring at half
+// rate while one is shown, and the main loop analyzes its newest
+// Spectrum::FFT_SIZE samples once per frame (spectrum.h)
+enum DisplayView { VIEW_EYE, VIEW_SPECTRUM, VIEW_SCOPE };
+static constexpr uint32_t VIEW_FRAME_MS = 33;
+static volatile int view = VIEW_EYE;
+static CaptureRing<2 * Spectrum::FFT_SIZE, 2> capture;
+static Spectrum spectrum;
+static float    view_samples[Spectrum::FFT_SIZE];
+
+// Hidden diagnostics pages (CC 119): the profiler at 64–95, only with
+// MS20_PROFILE=1, and the boot timings at 96–127
+static volatile bool show_profile = false;
+static volatile bool show_boot = false;
+
+// Render quality under CPU load. Always on: it times each callback with
+// the free-running TIM2 tick, not the profiler's DWT counter.
+static QualityGovernor governor;
+static uint32_t governor_budget;  // TIM2 ticks per block
+static int      quality_posted;   // level the main loop was last woken for
+
+// Output recorder (CC 118 ≥ 64): WAV files on the SD card, MS20_000.WAV up
+struct SdSink {
+    FIL file;
+
+    // Next unused name; false if there is none or it can't be created
+    bool Open() {
+        char name[16];
+        FILINFO info;
+        for (int i = 0; i < 1000; i++) {
+            std::snprintf(name, sizeof(name), "MS20_%03d.WAV", i);
+            FRESULT r = f_stat(name, &info);
+            if (r == FR_NO_FILE) return f_open(&file, name, FA_CREATE_NEW | FA_WRITE) == FR_OK;
+            if (r != FR_OK) return false;   // card error
+        }
+        return false;
+    }
+
+    bool Write(const uint8_t* data, uint32_t bytes) {
+        // SDMMC1 reads the buffer by DMA: push it out of the D-cache first
+        dsy_dma_clear_cache_for_buffer(const_cast<uint8_t*>(data), bytes);
+        UINT written;
+        return f_write(&file, data, bytes, &written) == FR_OK && written == bytes;
+    }
+
+    bool WriteAt(uint32_t offset, const uint8_t* data, uint32_t bytes) {
+        return f_lseek(&file, offset) == FR_OK && Write(data, bytes);
+    }
+
+    void Close() { f_close(&file); }
+};
+
+// Startup phases, before the loop and deferred to it (boot stages below)
+static BootProfile boot;
+
+static SdmmcHandler         sdmmc;
+static FatFSInterface       fsi;
+static bool                 sd_ready = false;     // driver up (BOOT_SD)
+static bool                 sd_mounted = false;   // card up (first recording)
+static bool                 record_pending = false;
+static SdSink               sd_sink;
+static Recorder<SdSink>     recorder;
+static uint32_t             recorder_rate;
+
 // ---------------------------------------------------------------------------
 // Minimal SSD1309 driver — batched page writes for fast, non-starving I2C
 // ---------------------------------------------------------------------------
 // libDaisy's SSD130x driver sends 1 byte per I2C transaction (74ms per
 // frame at 400 kHz). This driver sends 128 bytes per transaction (~3ms per
-// page), and the main loop polls MIDI between pages.
+// page) by DMA; completion posts EVENT_PAGE_DONE and the main loop starts
+// the next page.
 // ---------------------------------------------------------------------------
 
-static void OledCmd(uint8_t cmd) {
+static bool OledCmd(uint8_t cmd) {
     uint8_t buf[2] = {0x00, cmd};
-    oled_i2c.TransmitBlocking(OLED_ADDR, buf, 2, 10);
+    return oled_i2c.TransmitBlocking(OLED_ADDR, buf, 2, 10) == I2CHandle::Result::OK;
 }
 
-static void OledInit() {
-    // Standard SSD1306/SSD1309 128×64 init sequence
-    OledCmd(0xAE);        // display off
-    OledCmd(0xD5); OledCmd(0x80);  // clock divide
-    OledCmd(0xA8); OledCmd(0x3F);  // multiplex 64
-    OledCmd(0xD3); OledCmd(0x00);  // display offset 0
-    OledCmd(0x40);        // start line 0
-    OledCmd(0x8D); OledCmd(0x14);  // charge pump on
-    OledCmd(0xA1);        // segment remap
-    OledCmd(0xC8);        // COM scan descending
-    OledCmd(0xDA); OledCmd(0x12);  // COM pins
-    OledCmd(0x81); OledCmd(0x8F);  // contrast
-    OledCmd(0xD9); OledCmd(0x25);  // pre-charge
-    OledCmd(0xDB); OledCmd(0x34);  // VCOMH deselect
-    OledCmd(0xA4);        // resume from RAM
-    OledCmd(0xA6);        // normal display (not inverted)
-    OledCmd(0xAF);        // display on
-}
+// Standard SSD1306/SSD1309 128×64 init sequence. Sent from the main loop
+// a few commands per wake (boot stages below), ~75 µs a command.
+static constexpr uint8_t OLED_INIT[] = {
+    0xAE,          // display off
+    0xD5, 0x80,    // clock divide
+    0xA8, 0x3F,    // multiplex 64
+    0xD3, 0x00,    // display offset 0
+    0x40,          // start line 0
+    0x8D, 0x14,    // charge pump on
+    0xA1,          // segment remap
+    0xC8,          // COM scan descending
+    0xDA, 0x12,    // COM pins
+    0x81, 0x8F,    // contrast
+    0xD9, 0x25,    // pre-charge
+    0xDB, 0x34,    // VCOMH deselect
+    0xA4,          // resume from RAM
+    0xA6,          // normal display (not inverted)
+    0xAF,          // display on
+};
+static constexpr int OLED_CMDS_PER_STAGE = 4;
 
-// Send one page (128 bytes) in a single I2C transaction.
-// Returns in ~3ms at 400 kHz — short enough to not starve MIDI.
-static uint8_t page_buf[129];  // 0x40 prefix + 128 data bytes
+// Start sending one page (128 bytes) in a single I2C transaction. The
+// addressing commands go first in one short blocking write (~0.1 ms);
+// the data follows by DMA, ~3ms at 400 kHz, while the main loop sleeps.
+static uint8_t DMA_BUFFER_MEM_SECTION page_buf[129];  // 0x40 prefix + 128 data bytes
 
-static void OledSendPage(uint8_t page, const uint8_t* data) {
-    OledCmd(0xB0 + page);  // set page
-    OledCmd(0x00);         // low column = 0
-    OledCmd(0x10);         // high column = 0
+static void PageSent(void*, I2CHandle::Result) {
+    // On an error too: the next page goes out, the loop never stalls
+    events.Post(EVENT_PAGE_DONE);
+}
+
+static void OledStartPage(uint8_t page, const uint8_t* data) {
+    // Control byte 0x00: every byte after it is a command
+    uint8_t addr[4] = {0x00, static_cast<uint8_t>(0xB0 + page),  // set page
+                       0x00, 0x10};                               // column 0
+    oled_i2c.TransmitBlocking(OLED_ADDR, addr, sizeof(addr), 10);
     page_buf[0] = 0x40;   // I2C data mode prefix
     std::memcpy(&page_buf[1], data, 128);
-    oled_i2c.TransmitBlocking(OLED_ADDR, page_buf, 129, 50);
+    if (oled_i2c.TransmitDma(OLED_ADDR, page_buf, sizeof(page_buf), PageSent, nullptr)
+        != I2CHandle::Result::OK)
+        events.Post(EVENT_PAGE_DONE);
 }
 
 // ---------------------------------------------------------------------------
-// Audio callback — runs at 48 kHz, block size 48
+// Audio callback — AUDIO_SAMPLE_RATE, AUDIO_BLOCK_SIZE (default 48 kHz / 48)
 // ---------------------------------------------------------------------------
 static void AudioCallback(AudioHandle::InputBuffer in,
                           AudioHandle::OutputBuffer out,
                           size_t size) {
-    for (size_t i = 0; i < size; i++) {
-        float sig = 0.0f;
-        for (int v = 0; v < NUM_VOICES; v++)
-            sig += voices[v].Process(params);
-        sig *= (1.0f / NUM_VOICES);
-        sig = fx.Process(sig, params.overdrive);
-        sig *= params.output_gain;
-        out[0][i] = sig;
-        out[1][i] = sig;
+    uint32_t t0 = System::GetTick();
+    CycleProfiler& prof = engine.GetProfiler();
+    {
+        ProfileScope scope(prof, PROF_CALLBACK);
+        if (size > static_cast<size_t>(AUDIO_BLOCK_SIZE)) size = AUDIO_BLOCK_SIZE;
+        int level = governor.Level();
+        engine.SetQuality(level);
+        // A new level's voice cap is the main loop's to apply (PollMidi):
+        // wake it as MIDI would
+        if (level != quality_posted) {
+            quality_posted = level;
+            events.Post(EVENT_MIDI);
+        }
+        // Mono: left is the render buffer, the output gain loop mirrors right
+        engine.Process(out[0], static_cast<int>(size), out[1]);
     }
+    // Taken every block, so the filters' counters never wrap
+    Korg35LPF::NewtonStats nr = engine.TakeFilterStats();
+    prof.AddSolves(nr.solves, nr.iterations, nr.capped);
+    prof.EndBlock();
+    if (recorder.Push(out[0], size)) events.Post(EVENT_STORAGE);
+    if (view != VIEW_EYE) capture.Push(out[0], static_cast<int>(size));
+    governor.Update(System::GetTick() - t0, governor_budget);
+}
+
+// Profiler page: stage rows in ‰ of the block budget (min/avg/max), then
+// overruns, blocks since reset and the budget in kcycles, then the quality
+// level, smoothed load in ‰ and the governor's step count, then the
+// recorder's KB written, overruns and dropped samples, then the CC 11
+// filter's average iterations per solve ×1000, ksolves and capped solves
+static void RenderProfilePage() {
+    static constexpr char labels[PROF_NUM_STAGES][3] = {"VC", "OD", "FX", "OT", "CB"};
+    CycleProfiler::Snapshot snap;
+    if (!engine.GetProfiler().Read(snap) || !snap.budget) return;
+
+    EyeRenderer::StatRow rows[PROF_NUM_STAGES + 4];
+    for (int s = 0; s < PROF_NUM_STAGES; s++) {
+        const CycleProfiler::StageStats& st = snap.stage[s];
+        rows[s] = {{labels[s][0], labels[s][1], 0},
+                   {(int)(1000ull * st.min / snap.budget),
+                    (int)(1000ull * st.avg / snap.budget),
+                    (int)(1000ull * st.max / snap.budget)}};
+    }
+    rows[PROF_NUM_STAGES] = {{'O', 'R', 0},
+                             {(int)snap.overruns, (int)(snap.blocks % 100000),
+                              (int)(snap.budget / 1000)}};
+    rows[PROF_NUM_STAGES + 1] = {{'Q', 'L', 0},
+                                 {governor.Level(), (int)(1000.0f * governor.Load()),
+                                  (int)(governor.Steps() % 100000)}};
+    rows[PROF_NUM_STAGES + 2] = {{'R', 'C', 0},
+                                 {(int)(recorder.DataBytes() / 1024 % 100000),
+                                  (int)recorder.Overruns(),
+                                  (int)(recorder.DroppedSamples() % 100000)}};
+    uint64_t avg_milli = snap.solves ? 1000ull * snap.iterations / snap.solves : 0;
+    rows[PROF_NUM_STAGES + 3] = {{'N', 'R', 0},
+                                 {(int)avg_milli, (int)(snap.solves / 1000 % 100000),
+                                  (int)std::min<uint32_t>(snap.capped, 99999)}};
+    eye.RenderStats(rows, PROF_NUM_STAGES + 4);
+}
+
+// Boot timings page (CC 119 ≥ 96): per phase, µs spent in it, then when
+// it ended in µs and in ms since the clocks came up (boot_profile.h)
+static void RenderBootPage() {
+    EyeRenderer::StatRow rows[BootProfile::MAX_PHASES];
+    int n = boot.Count();
+    for (int i = 0; i < n; i++) {
+        const BootProfile::Phase& ph = boot.Get(i);
+        rows[i] = {{ph.label[0], ph.label[1], 0},
+                   {(int)std::min<uint32_t>(boot.DurationUs(i), 99999),
+                    (int)std::min<uint32_t>(ph.end_us, 99999),
+                    (int)(ph.end_us / 1000 % 100000)}};
+    }
+    eye.RenderStats(rows, n);
+}
+
+// Ask for a new file, or have the recorder finish the current one. The
+// card work itself runs from the loop (ServiceStorage), not here.
+static void SetRecording(bool on) {
+    if (!on) {
+        record_pending = false;
+        recorder.Stop();
+    } else if (sd_ready && !recorder.Recording()) {
+        record_pending = true;
+        events.Post(EVENT_STORAGE);
+    }
+}
+
+// One piece of storage work per wake. A pending start takes two: mounting
+// the card on the first recording, which can take a few hundred ms, then
+// opening the file, with MIDI serviced in between.
+static bool ServiceStorage() {
+    if (!record_pending) return recorder.Service();
+    if (!sd_mounted) {
+        sd_mounted = f_mount(&fsi.GetSDFileSystem(), "/", 1) == FR_OK;
+        record_pending = sd_mounted;   // no card: drop it, retry on the next CC
+        return sd_mounted;
+    }
+    record_pending = false;
+    if (!recorder.Recording() && sd_sink.Open()) recorder.Start(sd_sink, recorder_rate);
+    return false;
 }
 
 // ---------------------------------------------------------------------------
 // MIDI polling helper — call frequently to avoid buffer overflow
 // ---------------------------------------------------------------------------
-static void PollMidi() {
-    midi_uart.Listen();
-    while (midi_uart.HasEvents()) {
-        MidiEvent event = midi_uart.PopEvent();
-        if (event.channel != MIDI_CHANNEL) continue;
-        hw.SetLed(true);
-        switch (event.type) {
-            case NoteOn: {
-                auto note = event.AsNoteOn();
-                if (note.velocity > 0) {
-                    int vi = allocator.NoteOn(note.note);
-                    voices[vi].NoteOn(note.note, note.velocity);
-                    eye.NoteOn();
-                } else {
-                    int vi = allocator.NoteOff(note.note);
-                    if (vi >= 0) voices[vi].NoteOff(note.note);
-                    if (!allocator.AnyGated()) {
-                        eye.NoteOff();
-                        hw.SetLed(false);
-                    }
-                }
-                break;
-            }
-            case NoteOff: {
-                auto note = event.AsNoteOn();
-                int vi = allocator.NoteOff(note.note);
-                if (vi >= 0) voices[vi].NoteOff(note.note);
-                if (!allocator.AnyGated()) {
-                    eye.NoteOff();
-                    hw.SetLed(false);
-                }
+static void HandleMidiEvent(MidiEvent& event) {
+    if (event.channel != MIDI_CHANNEL) return;
+    hw.SetLed(true);
+    switch (event.type) {
+        case NoteOn: {
+            auto note = event.AsNoteOn();
+            engine.NoteOn(note.note, note.velocity);
+            if (note.velocity > 0) eye.NoteOn();
+            break;
+        }
+        case NoteOff: {
+            auto note = event.AsNoteOn();
+            engine.NoteOff(note.note);
+            break;
+        }
+        case ControlChange: {
+            auto cc = event.AsControlChange();
+            if (cc.control_number == CC_DIAG) {
+                bool profile = CycleProfiler::ENABLED && cc.value >= 64 && cc.value < 96;
+                if (profile && !show_profile) engine.GetProfiler().RequestReset();
+                show_profile = profile;
+                show_boot = cc.value >= 96;
                 break;
             }
-            case ControlChange: {
-                auto cc = event.AsControlChange();
-                params.HandleCC(cc.control_number, cc.value);
+            if (cc.control_number == CC_VIEW) {
+                view = cc.value < 43 ? VIEW_EYE : cc.value < 86 ? VIEW_SPECTRUM : VIEW_SCOPE;
                 break;
             }
-            case PitchBend: {
-                auto bend = event.AsPitchBend();
-                params.HandlePitchBend(bend.value);
+            if (cc.control_number == CC_RECORD) {
+                SetRecording(cc.value >= 64);
                 break;
             }
-            default: break;
+            engine.ControlChange(cc.control_number, cc.value);
+            break;
+        }
+        case PitchBend: {
+            auto bend = event.AsPitchBend();
+            engine.PitchBend(bend.value);
+            break;
         }
+        default: break;
+    }
+    if ((event.type == NoteOn || event.type == NoteOff) && !engine.AnyGated()) {
+        eye.NoteOff();
+        hw.SetLed(false);
+    }
+}
+
+static void PollMidi() {
+    // The governor's level is published atomically by the audio callback;
+    // the allocator is ours, so its voice cap changes here, never mid-NoteOn
+    engine.ApplyVoiceCap(governor.Level());
+
+    // Listen() restarts reception after a UART overrun
+    midi_uart.Listen();
+    while (midi_uart.HasEvents()) {
+        MidiEvent event = midi_uart.PopEvent();
+        HandleMidiEvent(event);
     }
 
     midi_usb.Listen();
     while (midi_usb.HasEvents()) {
         MidiEvent event = midi_usb.PopEvent();
-        if (event.channel != MIDI_CHANNEL) continue;
-        hw.SetLed(true);
-        switch (event.type) {
-            case NoteOn: {
-                auto note = event.AsNoteOn();
-                if (note.velocity > 0) {
-                    int vi = allocator.NoteOn(note.note);
-                    voices[vi].NoteOn(note.note, note.velocity);
-                    eye.NoteOn();
-                } else {
-                    int vi = allocator.NoteOff(note.note);
-                    if (vi >= 0) voices[vi].NoteOff(note.note);
-                    if (!allocator.AnyGated()) {
-                        eye.NoteOff();
-                        hw.SetLed(false);
-                    }
-                }
-                break;
-            }
-            case NoteOff: {
-                auto note = event.AsNoteOn();
-                int vi = allocator.NoteOff(note.note);
-                if (vi >= 0) voices[vi].NoteOff(note.note);
-                if (!allocator.AnyGated()) {
-                    eye.NoteOff();
-                    hw.SetLed(false);
-                }
-                break;
-            }
-            case ControlChange: {
-                auto cc = event.AsControlChange();
-                params.HandleCC(cc.control_number, cc.value);
-                break;
-            }
-            case PitchBend: {
-                auto bend = event.AsPitchBend();
-                params.HandlePitchBend(bend.value);
-                break;
-            }
-            default: break;
+        HandleMidiEvent(event);
+    }
+}
+
+static void LoopTimerElapsed(void*) {
+    loop_timer.Stop();
+    events.Post(EVENT_TIMER);
+}
+
+// ---------------------------------------------------------------------------
+// Deferred boot stages
+// ---------------------------------------------------------------------------
+// main() only sets up what the first note needs: clocks, the engine, MIDI
+// and audio. The rest runs from the loop, one short stage per wake, with
+// MIDI serviced in between. Until the OLED has been initialised no frame
+// is rendered; if it doesn't answer, the display stays off.
+// ---------------------------------------------------------------------------
+enum BootStage { BOOT_VIEWS, BOOT_OLED_BUS, BOOT_OLED_CMDS, BOOT_SD, BOOT_DONE };
+static int  boot_stage    = BOOT_VIEWS;
+static int  oled_cmd_next = 0;
+static bool display_ready = false;
+
+// One stage; true while more remain
+static bool ServiceBoot() {
+    switch (boot_stage) {
+        case BOOT_VIEWS:
+            spectrum.Init(hw.AudioSampleRate() / 2);   // the capture ring's rate
+            boot.Mark("VW", System::GetUs());
+            boot_stage = BOOT_OLED_BUS;
+            break;
+        case BOOT_OLED_BUS: {
+            boot_stage = EyeRenderer::ENABLED ? BOOT_OLED_CMDS : BOOT_SD;
+            if (!EyeRenderer::ENABLED) break;
+            // I2C1 at 400 kHz (D11=SCL, D12=SDA)
+            I2CHandle::Config i2c_cfg;
+            i2c_cfg.periph         = I2CHandle::Config::Peripheral::I2C_1;
+            i2c_cfg.speed          = I2CHandle::Config::Speed::I2C_400KHZ;
+            i2c_cfg.mode           = I2CHandle::Config::Mode::I2C_MASTER;
+            i2c_cfg.pin_config.scl = {DSY_GPIOB, 8};
+            i2c_cfg.pin_config.sda = {DSY_GPIOB, 9};
+            oled_i2c.Init(i2c_cfg);
+            break;
+        }
+        case BOOT_OLED_CMDS: {
+            constexpr int total = sizeof(OLED_INIT);
+            int end = std::min(oled_cmd_next + OLED_CMDS_PER_STAGE, total);
+            bool ok = true;
+            while (ok && oled_cmd_next < end) ok = OledCmd(OLED_INIT[oled_cmd_next++]);
+            if (ok && oled_cmd_next < total) break;
+            display_ready = ok;
+            boot.Mark("OL", System::GetUs());
+            boot_stage = BOOT_SD;
+            break;
+        }
+        case BOOT_SD: {
+            // SDMMC1, 4-bit (D1–D6). The card itself is mounted on the
+            // first recording (ServiceStorage): that can take a few hundred
+            // ms, which boot shouldn't spend on a card that may never be used.
+            SdmmcHandler::Config sd_cfg;
+            sd_cfg.Defaults();
+            sdmmc.Init(sd_cfg);
+            fsi.Init(FatFSInterface::Config::MEDIA_SD);
+            sd_ready = true;
+            boot.Mark("SD", System::GetUs());
+            boot_stage = BOOT_DONE;
+            break;
         }
+        default: break;
     }
+    return boot_stage != BOOT_DONE;
 }
 
+// ---------------------------------------------------------------------------
+// The Seed as EventLoop's board
+// ---------------------------------------------------------------------------
+static constexpr uint32_t STATS_FRAME_MS = 100;   // profiler page refresh
+
+struct SeedBoard {
+    Params* params;
+
+    uint32_t NowMs() { return System::GetNow(); }
+
+    // WFI with interrupts masked: one that fires between the check and the
+    // WFI stays pending and ends the WFI at once, so no wake is lost. The
+    // HAL's 1 kHz SysTick is paused meanwhile (GetNow runs on TIM2). WFI
+    // ends on any interrupt, including the audio DMA one every block; the
+    // brief unmask lets it run, and unless it posted a flag the core goes
+    // straight back to WFI without returning to the loop.
+    void Sleep(const EventFlags& flags) {
+        __disable_irq();
+        while (!flags.Pending()) {
+            HAL_SuspendTick();
+            __WFI();
+            HAL_ResumeTick();
+            __enable_irq();
+            __disable_irq();
+        }
+        __enable_irq();
+    }
+
+    void ArmTimer(uint32_t ms) {
+        loop_timer.Stop();
+        loop_timer.SetPeriod(ms * loop_timer_ticks_per_ms - 1);
+        TIM5->CNT = 0;
+        loop_timer.Start();
+    }
+
+    void ServiceMidi() { PollMidi(); }
+    void ReadPots(float dt_s) { AdcPotsRead(hw, *params, dt_s); }
+
+    uint32_t FramePeriodMs() {
+        if (!EyeRenderer::ENABLED || !display_ready) return 0;
+        if (show_boot || (CycleProfiler::ENABLED && show_profile)) return STATS_FRAME_MS;
+        return view == VIEW_EYE ? eye.FramePeriodMs() : VIEW_FRAME_MS;
+    }
+
+    bool PrepareFrame(float dt_s) {
+        if (show_boot) {
+            RenderBootPage();
+            return true;
+        }
+        if (CycleProfiler::ENABLED && show_profile) {
+            RenderProfilePage();
+            return true;
+        }
+        if (view != VIEW_EYE) {
+            // Nothing to show until the ring has filled once
+            if (!capture.Latest(view_samples, Spectrum::FFT_SIZE)) return false;
+            if (view == VIEW_SPECTRUM)
+                eye.RenderSpectrum(spectrum.Analyze(view_samples), Spectrum::NUM_BARS,
+                                   spectrum.BarForHz(ScaleCutoff(params->cc_cutoff)));
+            else
+                eye.RenderScope(Spectrum::Trace(view_samples), Spectrum::SCOPE_W);
+            return true;
+        }
+        eye.SetQuality(governor.Level());
+        if (!eye.Advance(*params, dt_s)) return false;
+        eye.Render();
+        return true;
+    }
+
+    void StartPage(int page) {
+        OledStartPage(static_cast<uint8_t>(page), &eye.Buffer()[page * 128]);
+    }
+
+    bool ServiceStorage() { return ::ServiceStorage(); }
+    bool ServiceBoot() { return ::ServiceBoot(); }
+};
+
+static SeedBoard board;
+static EventLoop<SeedBoard> main_loop;
+
 // ---------------------------------------------------------------------------
 // Main
 // ---------------------------------------------------------------------------
 int main(void) {
+    // Boot phases are marked on System::GetUs(), TIM2's µs count, which
+    // hw.Init starts right after the clocks: HW is the rest of hw.Init
     hw.Init();
-    hw.SetAudioBlockSize(48);
-    hw.SetAudioSampleRate(SaiHandle::Config::SampleRate::SAI_48KHZ);
+    // Before anything renders: the audio interrupt inherits it (FPDSCR)
+    EnableFlushToZero();
+    hw.SetAudioBlockSize(AUDIO_BLOCK_SIZE);
+    hw.SetAudioSampleRate(AUDIO_SAMPLE_RATE == 96000
+                              ? SaiHandle::Config::SampleRate::SAI_96KHZ
+                              : SaiHandle::Config::SampleRate::SAI_48KHZ);
+    boot.Mark("HW", System::GetUs());
 
     float sample_rate = hw.AudioSampleRate();
 
-    for (int i = 0; i < NUM_VOICES; i++)
-        voices[i].Init(sample_rate);
-    allocator.Init();
-    fx.Init(sample_rate);
-    params.Update();
+    CycleProfiler::InitCounter();
+    engine.GetProfiler().SetBudget(static_cast<uint32_t>(
+        System::GetSysClkFreq() / sample_rate * hw.AudioBlockSize()));
+    governor_budget = static_cast<uint32_t>(
+        System::GetTickFreq() / sample_rate * hw.AudioBlockSize());
+    governor.Init(sample_rate / hw.AudioBlockSize());
+
+    fx_arena.Init(fx_arena_mem, FX_ARENA_FLOATS);
+    engine.Init(sample_rate, fx_arena);
+    Params& params = engine.GetParams();
+    eye.Init();   // before MIDI: note handlers open and close the eye
+    boot.Mark("EN", System::GetUs());
 
     // MIDI: UART on pin D14 (USART1 RX)
-    MidiUartHandler::Config uart_cfg;
+    MidiUart::Config uart_cfg;
     uart_cfg.transport_config.rx = DaisySeed::GetPin(14);
     uart_cfg.transport_config.periph =
         UartHandler::Config::Peripheral::USART_1;
@@ -223,53 +579,38 @@ int main(void) {
     midi_uart.StartReceive();
 
     // MIDI: USB
-    MidiUsbHandler::Config usb_cfg;
+    MidiUsb::Config usb_cfg;
     midi_usb.Init(usb_cfg);
     midi_usb.StartReceive();
+    boot.Mark("MI", System::GetUs());
 
-    eye.Init();
-
-    // ADC: 9 pots on A0–A8
+    // ADC: 9 pots on A0–A8, converted continuously by DMA in the
+    // background; the loop reads the latest values on its pot deadline
     AdcPotsInit(hw);
 
-    // Start audio — runs at interrupt priority
-    hw.StartAudio(AudioCallback);
-
-    // OLED display: I2C1 at 400 kHz (D11=SCL, D12=SDA)
-    if (EyeRenderer::ENABLED) {
-        I2CHandle::Config i2c_cfg;
-        i2c_cfg.periph         = I2CHandle::Config::Peripheral::I2C_1;
-        i2c_cfg.speed          = I2CHandle::Config::Speed::I2C_400KHZ;
-        i2c_cfg.mode           = I2CHandle::Config::Mode::I2C_MASTER;
-        i2c_cfg.pin_config.scl = {DSY_GPIOB, 8};
-        i2c_cfg.pin_config.sda = {DSY_GPIOB, 9};
-        oled_i2c.Init(i2c_cfg);
-        OledInit();
-    }
-
-    // Main loop
-    uint32_t last_frame = 0;
+    // Loop timer: TIM5 counting at 10 kHz, interrupt on the period
+    TimerHandle::Config tim_cfg;
+    tim_cfg.periph     = TimerHandle::Config::Peripheral::TIM_5;
+    tim_cfg.dir        = TimerHandle::Config::CounterDir::UP;
+    tim_cfg.enable_irq = true;
+    loop_timer.Init(tim_cfg);
+    loop_timer.SetPrescaler(loop_timer.GetFreq() / 10000 - 1);
+    TIM5->EGR = TIM_EGR_UG;   // load the prescaler now...
+    TIM5->SR  = 0;            // ...without an update interrupt
+    loop_timer_ticks_per_ms = 10;
+    loop_timer.SetCallback(LoopTimerElapsed);
 
-    while (1) {
-        PollMidi();
+    recorder_rate = static_cast<uint32_t>(sample_rate);
 
-        uint32_t now = System::GetNow();
-        if (now - last_frame >= 50) {  // ~20 fps target
-            last_frame = now;
-
-            AdcPotsRead(hw, params);
-
-            if (EyeRenderer::ENABLED) {
-
-                eye.Render(params);
-                const uint8_t* buf = eye.Buffer();
+    // Start audio — runs at interrupt priority. From here, and the loop
+    // below, a note plays; the OLED, output views and SD card follow as
+    // deferred boot stages.
+    hw.StartAudio(AudioCallback);
+    boot.Mark("AU", System::GetUs());
 
-                // Send 8 pages, polling MIDI between each (~3ms per page)
-                for (uint8_t page = 0; page < 8; page++) {
-                    OledSendPage(page, &buf[page * 128]);
-                    PollMidi();
-                }
-            }
-        }
-    }
+    // Main loop: sleeps until MIDI, a finished OLED page or the loop timer
+    // (pots every 50 ms, the eye at the rate EyeRenderer asks for) wakes it
+    board.params = &params;
+    main_loop.Init(board, events);
+    while (1) main_loop.RunOnce();
 }
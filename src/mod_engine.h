@@ -0,0 +1,191 @@
+#pragma once
+// =============================================================================
+// mod_engine.h — Control-rate LFOs, mod envelopes and a CC routing table
+// =============================================================================
+// Sources are evaluated once per control tick (MOD_INTERVAL samples, or the
+// block if it is shorter) and summed per voice into a VoiceMod: pitch and
+// cutoff multipliers at both ends of the tick, plus a fold offset. The voice
+// kernels ramp the multipliers linearly across the tick — one add per sample
+// — so a route costs two exp2f per voice per tick, not per sample. Fold is
+// held for the tick: it only selects the kernel and scales a gain.
+//
+// Routing is a fixed table; each route's depth is a bipolar CC where 64 is
+// off. While every depth is off (and the last ramp has settled) Running() is
+// false and SynthEngine renders exactly as it would without the engine.
+//
+// Header-only, no Daisy dependencies.
+// =============================================================================
+
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include "params.h"
+
+constexpr int MOD_INTERVAL = 16;  // samples per control tick (3 kHz at 48 kHz)
+
+enum ModSource { MOD_SRC_LFO1, MOD_SRC_LFO2, MOD_SRC_ENV, MOD_NUM_SOURCES };
+enum ModDest   { MOD_DST_PITCH, MOD_DST_CUTOFF, MOD_DST_FOLD, MOD_NUM_DESTS };
+
+struct ModRoute {
+    int       cc;      // depth CC: 0 = −range, 64 = off, 127 = +range
+    ModSource src;     // LFOs are bipolar, the envelope is 0–1
+    ModDest   dst;
+    float     range;   // semitones (pitch), octaves (cutoff), fold amount
+};
+
+constexpr ModRoute MOD_ROUTES[] = {
+    {CC_MOD_LFO1_PITCH,  MOD_SRC_LFO1, MOD_DST_PITCH,   1.0f},  // vibrato
+    {CC_MOD_LFO1_CUTOFF, MOD_SRC_LFO1, MOD_DST_CUTOFF,  2.0f},  // wah
+    {CC_MOD_LFO2_CUTOFF, MOD_SRC_LFO2, MOD_DST_CUTOFF,  2.0f},  // random steps
+    {CC_MOD_LFO2_FOLD,   MOD_SRC_LFO2, MOD_DST_FOLD,    0.5f},
+    {CC_MOD_ENV_PITCH,   MOD_SRC_ENV,  MOD_DST_PITCH,  12.0f},  // pitch blip
+    {CC_MOD_ENV_CUTOFF,  MOD_SRC_ENV,  MOD_DST_CUTOFF,  4.0f},  // second filter env
+};
+constexpr int MOD_NUM_ROUTES = sizeof(MOD_ROUTES) / sizeof(MOD_ROUTES[0]);
+
+// One voice's modulation for one tick (see Voice::ProcessBlock)
+struct VoiceMod {
+    float pitch_from  = 1.0f, pitch_to  = 1.0f;  // frequency multipliers
+    float cutoff_from = 1.0f, cutoff_to = 1.0f;  // cutoff multipliers
+    float fold = 0.0f;                           // added to Params::fold_amount
+};
+
+template <int N>
+class ModEngine {
+public:
+    void Init(float sample_rate) {
+        sr_ = sample_rate;
+        lfo_phase_[0] = lfo_phase_[1] = 0.0f;
+        lfo_rate_[0] = lfo_rate_[1] = ScaleLfoRate(64.0f / 127.0f);
+        sh_value_ = 0.0f;
+        rng_ = 0x2545F491u;
+        env_decay_s_ = ScaleDecay(64.0f / 127.0f);
+        coeff_n_ = 0;
+        for (int r = 0; r < MOD_NUM_ROUTES; r++) depth_[r] = 0.0f;
+        for (int v = 0; v < N; v++) {
+            env_[v] = 0.0f;
+            env_attack_[v] = false;
+            mod_[v] = VoiceMod();
+        }
+        settled_ = true;
+        UpdateRouting();
+    }
+
+    // Handle a MIDI CC message. Returns true if it was one of ours.
+    bool HandleCC(int cc_num, int cc_val) {
+        float norm = static_cast<float>(cc_val) / 127.0f;
+        switch (cc_num) {
+            case CC_LFO1_RATE:     lfo_rate_[0] = ScaleLfoRate(norm); return true;
+            case CC_LFO2_RATE:     lfo_rate_[1] = ScaleLfoRate(norm); return true;
+            case CC_MOD_ENV_DECAY: env_decay_s_ = ScaleDecay(norm); coeff_n_ = 0; return true;
+            default: break;
+        }
+        for (int r = 0; r < MOD_NUM_ROUTES; r++) {
+            if (MOD_ROUTES[r].cc != cc_num) continue;
+            depth_[r] = std::clamp(static_cast<float>(cc_val - 64) / 63.0f, -1.0f, 1.0f);
+            UpdateRouting();
+            return true;
+        }
+        return false;
+    }
+
+    // Retrigger voice v's mod envelope (attack from its current level)
+    void NoteOn(int v) { env_attack_[v] = true; }
+
+    // False while no route is active and every voice's ramp has returned to
+    // identity: the caller can skip the VoiceMods entirely (and still Tick).
+    bool Running() const { return routed_ || !settled_; }
+
+    // Advance every source by n samples and compute the VoiceMods for them
+    void Tick(int n) {
+        float dt = static_cast<float>(n) / sr_;
+
+        // LFO1: triangle. LFO2: new random step each cycle.
+        lfo_phase_[0] += lfo_rate_[0] * dt;
+        lfo_phase_[0] -= std::floor(lfo_phase_[0]);
+        lfo_phase_[1] += lfo_rate_[1] * dt;
+        if (lfo_phase_[1] >= 1.0f) {
+            lfo_phase_[1] -= std::floor(lfo_phase_[1]);
+            sh_value_ = NextRandom();
+        }
+        float src[MOD_NUM_SOURCES];
+        src[MOD_SRC_LFO1] = 1.0f - 4.0f * std::fabs(lfo_phase_[0] - 0.5f);
+        src[MOD_SRC_LFO2] = sh_value_;
+
+        // Envelope coefficients per tick length (normally one of two sizes)
+        if (n != coeff_n_) {
+            coeff_n_ = n;
+            attack_coeff_ = 1.0f - std::exp(-dt / ENV_ATTACK_S);
+            decay_coeff_  = 1.0f - std::exp(-dt / env_decay_s_);
+        }
+
+        settled_ = true;
+        for (int v = 0; v < N; v++) {
+            if (env_attack_[v]) {
+                env_[v] += attack_coeff_ * (1.0f - env_[v]);
+                if (env_[v] >= 0.999f) env_attack_[v] = false;
+            } else {
+                env_[v] -= decay_coeff_ * env_[v];
+                if (env_[v] < 1e-6f) env_[v] = 0.0f;
+            }
+            src[MOD_SRC_ENV] = env_[v];
+
+            float sum[MOD_NUM_DESTS] = {0.0f, 0.0f, 0.0f};
+            for (int r = 0; r < MOD_NUM_ROUTES; r++)
+                sum[MOD_ROUTES[r].dst] += depth_[r] * MOD_ROUTES[r].range * src[MOD_ROUTES[r].src];
+
+            VoiceMod& m = mod_[v];
+            m.pitch_from  = m.pitch_to;
+            m.cutoff_from = m.cutoff_to;
+            m.pitch_to  = dest_routed_[MOD_DST_PITCH]  ? std::exp2(sum[MOD_DST_PITCH] / 12.0f) : 1.0f;
+            m.cutoff_to = dest_routed_[MOD_DST_CUTOFF] ? std::exp2(sum[MOD_DST_CUTOFF]) : 1.0f;
+            m.fold = sum[MOD_DST_FOLD];
+            if (m.pitch_from != 1.0f || m.cutoff_from != 1.0f ||
+                m.pitch_to != 1.0f || m.cutoff_to != 1.0f || m.fold != 0.0f)
+                settled_ = false;
+        }
+    }
+
+    const VoiceMod& ForVoice(int v) const { return mod_[v]; }
+
+private:
+    void UpdateRouting() {
+        for (int d = 0; d < MOD_NUM_DESTS; d++) dest_routed_[d] = false;
+        routed_ = false;
+        for (int r = 0; r < MOD_NUM_ROUTES; r++) {
+            if (depth_[r] == 0.0f) continue;
+            dest_routed_[MOD_ROUTES[r].dst] = true;
+            routed_ = true;
+        }
+        if (routed_) settled_ = false;
+    }
+
+    // xorshift32 → [-1, 1)
+    float NextRandom() {
+        rng_ ^= rng_ << 13;
+        rng_ ^= rng_ >> 17;
+        rng_ ^= rng_ << 5;
+        return static_cast<float>(static_cast<int32_t>(rng_)) * (1.0f / 2147483648.0f);
+    }
+
+    float sr_;
+
+    float    lfo_phase_[2];
+    float    lfo_rate_[2];    // Hz
+    float    sh_value_;       // LFO2 output
+    uint32_t rng_;
+
+    float env_decay_s_;
+    int   coeff_n_;           // tick length the coefficients are for (0 = stale)
+    float attack_coeff_;
+    float decay_coeff_;
+    float env_[N];
+    bool  env_attack_[N];
+
+    float depth_[MOD_NUM_ROUTES];   // -1 – 1
+    bool  dest_routed_[MOD_NUM_DESTS];
+    bool  routed_;
+    bool  settled_;
+
+    VoiceMod mod_[N];
+};
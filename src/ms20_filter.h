@@ -18,10 +18,20 @@
 // delay-free feedback loop analytically — no unit-delay in the feedback path,
 // so the resonance peak stays consistent across all frequencies.
 //
+// The default model resolves the loop linearly and saturates the previous
+// sample's output, so the tanh itself sits behind a unit delay. SetAccurate
+// swaps in a Newton-Raphson solve of the full implicit loop,
+//   y = G²·(in − K·tanh(y)) + S,
+// warm-started from the previous sample's y. It runs at most NR_MAX_ITERS
+// iterations, one tanh each, and stops as soon as the error left after a
+// step is provably below NR_TOL. TakeNewtonStats reports how many
+// iterations that took.
+//
 // Self-contained. No Daisy dependencies. Drop into any C++ project.
 // =============================================================================
 
 #include <cmath>
+#include <cstdint>
 #include <algorithm>
 
 #ifndef M_PI
@@ -30,11 +40,32 @@
 
 class Korg35LPF {
 public:
+    static constexpr int   NR_MAX_ITERS = 4;      // worst case: 4 tanh per tick
+    static constexpr float NR_TOL       = 1e-5f;  // error in y that counts as converged
+
+    // Accurate-mode counters, summed since the last TakeNewtonStats
+    struct NewtonStats {
+        uint32_t solves = 0;       // filter ticks (oversampled)
+        uint32_t iterations = 0;
+        uint32_t capped = 0;       // solves that hit NR_MAX_ITERS unconverged
+
+        float Average() const {
+            return solves ? static_cast<float>(iterations) / static_cast<float>(solves) : 0.0f;
+        }
+    };
+
     void Init(float sample_rate) {
-        sr_ = sample_rate * 2.0f;  // 2x oversampling: internal rate is 96 kHz
+        // 2x oversampling below 88.2 kHz (internal rate 96 kHz at 48 kHz);
+        // at 88.2/96 kHz the host rate already has that headroom
+        base_sr_ = sample_rate;
+        native_oversample_ = sample_rate < 88000.0f ? 2 : 1;
+        oversample_ = native_oversample_;
+        sr_ = sample_rate * static_cast<float>(oversample_);
         s1_ = 0.0f;
         s2_ = 0.0f;
         s3_ = 0.0f;
+        accurate_ = false;
+        stats_ = NewtonStats();
 
         SetCutoff(1000.0f);
         SetResonance(0.0f);
@@ -42,9 +73,31 @@ public:
 
     // Cutoff frequency in Hz. Range: 5 – sr/2.
     void SetCutoff(float freq) {
+        g_ = CutoffCoeff(freq);
+    }
+
+    // The prewarped integrator gain g = tan(π·fc/fs) that SetCutoff stores.
+    // Callers ramping the cutoff faster than they can afford tan() compute
+    // the endpoints here and interpolate g with SetCoeff.
+    float CutoffCoeff(float freq) const {
         freq = std::clamp(freq, 5.0f, sr_ * 0.5f);
-        g_ = std::tan(static_cast<float>(M_PI) * freq / sr_);
+        return std::tan(static_cast<float>(M_PI) * freq / sr_);
+    }
+    float Coeff() const { return g_; }
+    void SetCoeff(float g) { g_ = g; }
+
+    // Off runs the filter at the host rate (QUALITY_FILTER_1X). The state
+    // carries over and g is rescaled to the same cutoff at the new rate, so
+    // switching mid-note doesn't click.
+    void SetOversampling(bool on) {
+        int os = on ? native_oversample_ : 1;
+        if (os == oversample_) return;
+        float w = std::atan(g_) * static_cast<float>(oversample_) / static_cast<float>(os);
+        oversample_ = os;
+        sr_ = base_sr_ * static_cast<float>(os);
+        g_ = std::tan(std::min(w, static_cast<float>(M_PI) * 0.49f));
     }
+    int Oversample() const { return oversample_; }
 
     // Resonance: 0.0 = none, 1.0 = screaming.
     void SetResonance(float res) {
@@ -52,10 +105,28 @@ public:
         K_ = res * 20.0f;
     }
 
-    // Process one sample (2x oversampled internally)
+    // Newton-Raphson loop solve instead of the unit-delayed tanh
+    void SetAccurate(bool on) { accurate_ = on; }
+    bool Accurate() const { return accurate_; }
+
+    // Process one sample (oversampled internally, see Init)
     float Process(float in) {
-        ProcessSample(in);
-        return ProcessSample(in);
+        if (accurate_) {
+            float out = ProcessSampleNR(in);
+            if (oversample_ == 2) out = ProcessSampleNR(in);
+            return out;
+        }
+        float out = ProcessSample(in);
+        if (oversample_ == 2) out = ProcessSample(in);
+        return out;
+    }
+
+    // Add the accurate-mode counters to acc and clear them
+    void TakeNewtonStats(NewtonStats& acc) {
+        acc.solves += stats_.solves;
+        acc.iterations += stats_.iterations;
+        acc.capped += stats_.capped;
+        stats_ = NewtonStats();
     }
 
     // Clear state on note-on to prevent clicks
@@ -83,32 +154,75 @@ private:
         float lp2 = v2 + s2_;
         s2_ = lp2 + v2;
 
-        // Feedback state
+        // Feedback state. Release tails decay through the denormal range:
+        // the FPU flushes them (denormals.h).
         s3_ = lp2;
 
-        // Flush denormals to prevent FPU slowdown during release tails
-        s1_ = FlushDenormal(s1_);
-        s2_ = FlushDenormal(s2_);
-        s3_ = FlushDenormal(s3_);
-
         // Compensate passband gain loss from resonance feedback.
         // Without this, high K thins out everything except the resonant peak.
         return lp2 * (1.0f + K_ * 0.1f);
     }
 
+    // Same tick with the loop solved at the current sample. Both
+    // integrators are affine in u, so lp2 = G²·u + S with
+    // S = G(1−G)·s1 + (1−G)·s2. Newton on f(y) = y + G²K·tanh(y) − G²·in − S:
+    // f' ≥ 1 and |f''| ≤ 0.77·G²K (max |tanh''|), so the error left after a
+    // step is at most 0.385·G²K·step²: the exit test needs no extra tanh,
+    // and from the previous sample's y (s3_) one step usually does.
+    float ProcessSampleNR(float in) {
+        float G = g_ / (1.0f + g_);
+        float G2 = G * G;
+        float c = G2 * K_;
+        float a = G2 * in + G * (1.0f - G) * s1_ + (1.0f - G) * s2_;
+
+        float y = s3_;
+        float t = 0.0f;
+        int it = 0;
+        for (;;) {
+            t = Saturate(y);
+            float step = (y + c * t - a) / (1.0f + c * (1.0f - t * t));
+            y -= step;
+            // tanh at the new y to first order: saves a tanh per tick
+            t -= (1.0f - t * t) * step;
+            bool done = 0.385f * c * step * step < NR_TOL;
+            if (++it == NR_MAX_ITERS) {
+                if (!done) stats_.capped++;
+                break;
+            }
+            if (done) break;
+        }
+        stats_.solves++;
+        stats_.iterations += static_cast<uint32_t>(it);
+
+        float u = in - K_ * t;
+
+        float v1 = (u - s1_) * G;
+        float lp1 = v1 + s1_;
+        s1_ = lp1 + v1;
+
+        float v2 = (lp1 - s2_) * G;
+        float lp2 = v2 + s2_;
+        s2_ = lp2 + v2;
+
+        s3_ = lp2;
+
+        return lp2 * (1.0f + K_ * 0.1f);
+    }
+
     float Saturate(float x) {
         // Smooth saturation: tames feedback progressively for stable,
         // musical self-oscillation (closer to real OTA behavior)
         return std::tanh(x);
     }
 
-    static float FlushDenormal(float x) {
-        return (std::fabs(x) < 1e-20f) ? 0.0f : x;
-    }
-
-    float sr_;
+    int   oversample_;
+    int   native_oversample_;   // what Init picked; SetOversampling(true) restores it
+    float base_sr_;             // host rate
+    float sr_;                  // internal (oversampled) rate
     float g_;
     float K_;
+    bool  accurate_;
+    NewtonStats stats_;
 
     float s1_;  // LPF1 state
     float s2_;  // LPF2 state
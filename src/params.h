@@ -1,10 +1,12 @@
 #pragma once
 // =============================================================================
-// params.h — 8 CC values, scaling curves, and hardcoded defaults
+// params.h — CC map (1–13, 20–28, 117–119), scaling curves, and defaults
 // =============================================================================
 
 #include <cmath>
+#include <cstdint>
 #include <algorithm>
+#include <atomic>
 
 // MIDI CC assignments
 constexpr int CC_CUTOFF   = 1;
@@ -15,6 +17,26 @@ constexpr int CC_DECAY    = 5;
 constexpr int CC_AMP_ENV  = 6;
 constexpr int CC_FILT_ENV = 7;
 constexpr int CC_FX       = 8;
+constexpr int CC_FX_MIX   = 9;   // MIDI only (no pot): chorus/reverb crossfade
+constexpr int CC_CAB      = 10;  // MIDI only: ≥64 = convolution cabinet IR
+constexpr int CC_FILTER_NR = 11; // MIDI only: ≥64 = Newton-Raphson filter loop
+constexpr int CC_UNISON   = 12;  // MIDI only: saws per voice, 1–8 (unison.h)
+constexpr int CC_DETUNE   = 13;  // MIDI only: unison spread, 0–±50 cents
+
+// Modulation (MIDI only, handled by ModEngine — see mod_engine.h)
+constexpr int CC_LFO1_RATE       = 20;  // triangle, 0.05–20 Hz
+constexpr int CC_LFO2_RATE       = 21;  // sample & hold, 0.05–20 Hz
+constexpr int CC_MOD_ENV_DECAY   = 22;  // per-voice AD mod envelope, 5 ms – 5 s
+constexpr int CC_MOD_LFO1_PITCH  = 23;  // route depths: 64 = off, 0/127 = ∓/± full
+constexpr int CC_MOD_LFO1_CUTOFF = 24;
+constexpr int CC_MOD_LFO2_CUTOFF = 25;
+constexpr int CC_MOD_LFO2_FOLD   = 26;
+constexpr int CC_MOD_ENV_PITCH   = 27;
+constexpr int CC_MOD_ENV_CUTOFF  = 28;
+
+constexpr int CC_VIEW     = 117; // display: 0–42 eye, 43–85 spectrum, 86–127 scope (main.cpp)
+constexpr int CC_RECORD   = 118; // ≥64 records the output to SD, <64 stops (main.cpp)
+constexpr int CC_DIAG     = 119; // hidden: 64–95 profiler page, 96–127 boot timings (main.cpp)
 
 // MIDI channel (0-indexed, so channel 1 = 0)
 constexpr int MIDI_CHANNEL = 0;
@@ -27,6 +49,10 @@ constexpr float KEY_TRACKING       = 0.5f;    // 50% key tracking
 constexpr float PITCH_BEND_RANGE   = 2.0f;    // semitones
 constexpr float MAX_OUTPUT_GAIN     = 12.0f;   // full-CW pot ceiling
 
+// CCs 1–9 closer together than this glide from one value to the next over
+// the gap between them; further apart (or the first of a move) they jump
+constexpr float CC_GLIDE_MAX_S     = 0.1f;
+
 // -------------------------------------------------------------------------
 // CC Scaling Functions
 // -------------------------------------------------------------------------
@@ -54,6 +80,21 @@ inline float ScaleFilterEnvDepth(float cc_norm) {
     return x2 * x2;
 }
 
+// CC 12 → Unison saws per voice (1–8, 16 CC steps each)
+inline int ScaleUnison(float cc_norm) {
+    return 1 + static_cast<int>(cc_norm * 7.99f);
+}
+
+// CC 13 → Unison detune, ± cents at the outer saws (x² for fine chorusing)
+inline float ScaleDetune(float cc_norm) {
+    return 50.0f * cc_norm * cc_norm;
+}
+
+// CC 20/21 → LFO rate (0.05 – 20 Hz, exponential; CC 64 ≈ 1 Hz)
+inline float ScaleLfoRate(float cc_norm) {
+    return 0.05f * std::pow(20.0f / 0.05f, cc_norm);
+}
+
 // -------------------------------------------------------------------------
 // Synth Parameters — the runtime state updated by MIDI CCs
 // -------------------------------------------------------------------------
@@ -67,13 +108,19 @@ struct Params {
     float cc_decay    = 40.0f / 127.0f;  // CC 5  (40/127)
     float cc_amp_env  = 1.0f;            // CC 6  (127/127) full envelope
     float cc_filt_env = 0.0f;            // CC 7  (0/127)   no filter env
-    float cc_fx       = 0.0f;            // CC 8  (0/127)   dry
+    float cc_fx       = 0.0f;            // CC 8  (0/127)   no overdrive
+    float cc_fx_mix   = 0.0f;            // CC 9  (0/127)   dry
+    float cc_cab      = 0.0f;            // CC 10 (0/127)   one-pole cabinet
+    float cc_filter_nr = 0.0f;           // CC 11 (0/127)   fast filter loop
+    float cc_unison   = 0.0f;            // CC 12 (0/127)   one saw
+    float cc_detune   = 40.0f / 127.0f;  // CC 13 (40/127)  ±5 cents
     float cc_gain     = 0.775f;          // pot 8 — 0.775² × 2.0 ≈ 1.2 (audio taper)
 
     // Pitch bend: -1 to +1
     float pitch_bend = 0.0f;
 
-    // Derived parameters — set by Update() before audio starts
+    // Derived parameters — set by Update() before audio starts, then only
+    // by Advance() on the audio thread (main-loop writers call Changed())
     float cutoff_hz      = 0.0f;
     float resonance      = 0.0f;
     float sub_level      = 0.0f;
@@ -82,9 +129,15 @@ struct Params {
     float amp_env_depth  = 0.0f;
     float filt_env_depth = 0.0f;
     float overdrive      = 0.0f;
+    float fx_mix         = 0.0f;   // 0 dry, 0.5 chorus, 1 reverb (SPEC §6.3)
+    bool  cab_ir         = false;  // overdrive cabinet: IR instead of one-pole
+    bool  filter_nr      = false;  // Korg35 loop solved by Newton-Raphson
+    int   unison         = 1;      // saws per voice
+    float unison_detune  = 0.0f;   // ± cents at the outer saws
     float output_gain    = 0.0f;
 
-    // Recalculate derived values from raw CCs
+    // Recalculate derived values from raw CCs. Single-threaded setup only:
+    // once audio runs, the audio thread owns these fields.
     void Update() {
         cutoff_hz      = ScaleCutoff(cc_cutoff);
         resonance      = ScaleResonance(cc_res);
@@ -94,29 +147,139 @@ struct Params {
         amp_env_depth  = cc_amp_env;
         filt_env_depth = ScaleFilterEnvDepth(cc_filt_env);
         overdrive      = cc_fx;
+        fx_mix         = cc_fx_mix;
+        cab_ir         = cc_cab >= 0.5f;
+        filter_nr      = cc_filter_nr >= 0.5f;
+        unison         = ScaleUnison(cc_unison);
+        unison_detune  = ScaleDetune(cc_detune);
         output_gain    = std::max(0.05f, cc_gain * cc_gain * MAX_OUTPUT_GAIN);
     }
 
+    // A raw field was written outside the audio thread (a jumped CC, a
+    // pot): the next Advance() recomputes the derived values. The main loop
+    // never calls Update() itself, so it can't write back values computed
+    // from raw fields a glide step has since moved.
+    void Changed() {
+        std::atomic_signal_fence(std::memory_order_release);
+        changed_seq_++;
+    }
+
+    // Raw field a CC writes, or nullptr if it isn't one of ours
+    float* CCField(int cc_num) {
+        switch (cc_num) {
+            case CC_CUTOFF:   return &cc_cutoff;
+            case CC_RES:      return &cc_res;
+            case CC_SUB:      return &cc_sub;
+            case CC_FOLD:     return &cc_fold;
+            case CC_DECAY:    return &cc_decay;
+            case CC_AMP_ENV:  return &cc_amp_env;
+            case CC_FILT_ENV: return &cc_filt_env;
+            case CC_FX:       return &cc_fx;
+            case CC_FX_MIX:   return &cc_fx_mix;
+            case CC_CAB:      return &cc_cab;
+            case CC_FILTER_NR: return &cc_filter_nr;
+            case CC_UNISON:   return &cc_unison;
+            case CC_DETUNE:   return &cc_detune;
+            default: return nullptr;
+        }
+    }
+
     // Handle a MIDI CC message. Returns true if it was one of ours.
+    // A thinned CC stream (e.g. the JSFX under its byte budget) glides:
+    // the value ramps to each new CC over the gap since the one before,
+    // in Advance() on the audio thread. Anything else applies at once.
     bool HandleCC(int cc_num, int cc_val) {
+        float* field = CCField(cc_num);
+        if (!field) return false;
         float norm = static_cast<float>(cc_val) / 127.0f;
-        switch (cc_num) {
-            case CC_CUTOFF:   cc_cutoff   = norm; break;
-            case CC_RES:      cc_res      = norm; break;
-            case CC_SUB:      cc_sub      = norm; break;
-            case CC_FOLD:     cc_fold     = norm; break;
-            case CC_DECAY:    cc_decay    = norm; break;
-            case CC_AMP_ENV:  cc_amp_env  = norm; break;
-            case CC_FILT_ENV: cc_filt_env = norm; break;
-            case CC_FX:       cc_fx       = norm; break;
-            default: return false;
+        if (cc_num >= NUM_GLIDE_CCS) {
+            *field = norm;
+            Changed();
+            return true;
+        }
+
+        Glide& g = glide_[cc_num];
+        uint32_t now = clock_;
+        uint32_t gap = now - g.last_at;
+        g.target = norm;
+        g.len = (g.heard && gap <= glide_max_) ? gap : 0;
+        g.last_at = now;
+        g.heard = true;
+        if (!g.len) {
+            *field = norm;
+            Changed();
         }
-        Update();
+        std::atomic_signal_fence(std::memory_order_release);
+        g.seq++;                       // hands target and len to Advance
         return true;
     }
 
+    // Glide timing in samples. Until this is called every CC jumps.
+    void SetSampleRate(float sample_rate) {
+        glide_max_ = static_cast<uint32_t>(CC_GLIDE_MAX_S * sample_rate);
+    }
+
+    // Move gliding CCs on by n samples and recompute the derived values if
+    // anything moved or Changed() was called (audio thread, once per block)
+    void Advance(int n) {
+        clock_ += static_cast<uint32_t>(n);
+        bool moved = changed_seq_ != changed_seen_;
+        if (moved) {
+            changed_seen_ = changed_seq_;
+            std::atomic_signal_fence(std::memory_order_acquire);
+        }
+        for (int cc = 1; cc < NUM_GLIDE_CCS; cc++) {
+            Glide& g = glide_[cc];
+            float& v = *CCField(cc);
+            if (g.seq != g.seen) {
+                g.seen = g.seq;
+                std::atomic_signal_fence(std::memory_order_acquire);
+                g.end  = g.target;     // HandleCC may rewrite target mid-ramp
+                g.left = g.len;        // 0: HandleCC already jumped
+                g.step = g.len ? (g.end - v) / static_cast<float>(g.len) : 0.0f;
+                g.written = v;
+            }
+            if (!g.left) continue;
+            if (v != g.written) {      // a pot moved it since: the pot wins
+                g.left = 0;
+                continue;
+            }
+            uint32_t k = std::min(g.left, static_cast<uint32_t>(n));
+            g.left -= k;
+            v = g.left ? v + g.step * static_cast<float>(k) : g.end;
+            g.written = v;
+            moved = true;
+        }
+        if (moved) Update();
+    }
+
     // Handle pitch bend (14-bit, 0-16383, center 8192)
     void HandlePitchBend(int bend_val) {
         pitch_bend = (static_cast<float>(bend_val) - 8192.0f) / 8192.0f;
     }
+
+private:
+    static constexpr int NUM_GLIDE_CCS = CC_FX_MIX + 1;   // CCs 1–9
+
+    // HandleCC (main loop) writes target and len, then bumps seq; Advance
+    // (audio) starts the ramp when it sees a new seq and copies target to
+    // end, so a CC that lands mid-ramp can't move the running ramp's end
+    struct Glide {
+        float    target  = 0.0f;
+        float    end     = 0.0f;    // running ramp's target (audio)
+        uint32_t len     = 0;       // ramp length, samples (0 = jumped)
+        uint32_t seq     = 0;
+        uint32_t seen    = 0;       // last seq Advance started
+        uint32_t left    = 0;       // samples to go
+        float    step    = 0.0f;    // per sample
+        float    written = 0.0f;    // value Advance last left in the field
+        uint32_t last_at = 0;       // clock_ at the previous CC
+        bool     heard   = false;
+    };
+
+    Glide    glide_[NUM_GLIDE_CCS];
+    uint32_t clock_     = 0;        // samples rendered (Advance)
+    uint32_t glide_max_ = 0;        // CC_GLIDE_MAX_S in samples
+    uint32_t changed_seq_  = 0;     // bumped by Changed() (main loop)
+    uint32_t changed_seen_ = 0;     // last one Advance recomputed for
 };
@@ -0,0 +1,102 @@
+#pragma once
+// =============================================================================
+// pot_filter.h — Speed-adaptive pot smoothing (1-Euro filter + hysteresis)
+// =============================================================================
+// Header-only, no Daisy dependencies. One PotFilter per potentiometer.
+//
+// Pipeline per reading:
+//   raw → Median3 (kills I2C impulse spikes)
+//       → 1-Euro low-pass (cutoff rises with pot speed: heavy smoothing at
+//         rest, near-zero lag during fast sweeps)
+//       → backlash hysteresis (output only moves once the smoothed value
+//         pushes against a small window, then tracks it continuously)
+//
+// The old fixed IIR + 2% dead-zone had to trade rest jitter against sweep
+// lag, and quantized slow cutoff moves into 2% jumps. The backlash window
+// here is half a 0–127 step and never quantizes: once the pot is moving,
+// the output follows it with a constant offset of `hysteresis`.
+//
+// Reference: Casiez, Roussel, Vogel, "1€ Filter: A Simple Speed-based
+// Low-pass Filter for Noisy Input in Interactive Systems" (CHI 2012).
+// =============================================================================
+
+#include <cmath>
+
+struct PotFilterConfig {
+    float min_cutoff_hz = 0.8f;    // cutoff at rest — lower = less jitter
+    float beta          = 6.0f;    // cutoff gain per unit/s of pot speed
+    float d_cutoff_hz   = 2.0f;    // smoothing of the speed estimate
+    float hysteresis    = 0.004f;  // backlash half-width (~half a CC step)
+};
+
+// Median of three — kills impulse spikes that a low-pass can't
+static inline float Median3(float a, float b, float c) {
+    if (a > b) { float t = a; a = b; b = t; }
+    if (b > c) { b = c; }
+    if (a > b) { a = b; }
+    return a > b ? a : b;  // middle value
+}
+
+struct PotFilter {
+    // Snap all state to a physical position (first reading after boot)
+    void Reset(float raw) {
+        history_[0] = history_[1] = history_[2] = raw;
+        hist_idx_ = 0;
+        x_hat_  = raw;
+        dx_hat_ = 0.0f;
+        held_   = raw;
+        initialized_ = true;
+    }
+
+    // Feed one normalized 0–1 reading taken dt_s seconds after the previous
+    // one. Returns true if Value() changed — i.e. the pot is being moved and
+    // should overwrite whatever MIDI last wrote to the same parameter.
+    bool Process(float raw, float dt_s, const PotFilterConfig& cfg) {
+        if (!initialized_) {
+            Reset(raw);
+            return true;
+        }
+
+        history_[hist_idx_] = raw;
+        hist_idx_ = (hist_idx_ + 1) % 3;
+        float med = Median3(history_[0], history_[1], history_[2]);
+
+        // 1-Euro: smooth the derivative, then let it raise the cutoff
+        if (dt_s < 1e-4f) dt_s = 1e-4f;
+        float dx = (med - x_hat_) / dt_s;
+        dx_hat_ += Alpha(cfg.d_cutoff_hz, dt_s) * (dx - dx_hat_);
+        float cutoff = cfg.min_cutoff_hz + cfg.beta * std::fabs(dx_hat_);
+        x_hat_ += Alpha(cutoff, dt_s) * (med - x_hat_);
+
+        // Backlash hysteresis: drag the held value only when pushed
+        float prev = Value(cfg);
+        if (x_hat_ > held_ + cfg.hysteresis)      held_ = x_hat_ - cfg.hysteresis;
+        else if (x_hat_ < held_ - cfg.hysteresis) held_ = x_hat_ + cfg.hysteresis;
+        return Value(cfg) != prev;
+    }
+
+    // Current output, 0–1. Twice the backlash width is trimmed off each end
+    // so both rails are reachable from either direction and a pot resting
+    // against a rail (where ADC noise is one-sided) reads exactly 0 or 1.
+    float Value(const PotFilterConfig& cfg) const {
+        float h = 2.0f * cfg.hysteresis;
+        float v = (held_ - h) / (1.0f - 2.0f * h);
+        if (v < 0.0f) v = 0.0f;
+        if (v > 1.0f) v = 1.0f;
+        return v;
+    }
+
+private:
+    // One-pole coefficient for a cutoff in Hz at sample interval dt_s
+    static float Alpha(float cutoff_hz, float dt_s) {
+        float tau = 1.0f / (2.0f * 3.14159265f * cutoff_hz);
+        return 1.0f / (1.0f + tau / dt_s);
+    }
+
+    float history_[3] = {0.0f, 0.0f, 0.0f};  // last 3 raw readings for median
+    int   hist_idx_   = 0;                    // ring buffer write position
+    float x_hat_      = 0.0f;                 // 1-Euro smoothed value
+    float dx_hat_     = 0.0f;                 // smoothed speed, units/s
+    float held_       = 0.0f;                 // hysteresis output
+    bool  initialized_ = false;
+};
@@ -0,0 +1,127 @@
+#pragma once
+// =============================================================================
+// quality_governor.h — Steps render quality down under CPU load, and back up
+// =============================================================================
+// Fed the measured time of every audio callback against the block budget,
+// it picks a quality level for the next one. Each level keeps everything
+// the one before it dropped:
+//
+//   QUALITY_FULL         everything on
+//   QUALITY_FILTER_1X    Korg35 filters run at the audio rate, not 2x
+//   QUALITY_LEAN_FX      no cabinet IR, no reverb (the mix stops at pure
+//                        chorus), silent FX tails are dropped, not computed
+//   QUALITY_DROP_VOICE   one voice fewer (NUM_VOICES − 1)
+//   QUALITY_DROP_VOICES  two voices fewer (NUM_VOICES − 2)
+//
+// SynthEngine::SetQuality applies a level on the audio thread and
+// ApplyVoiceCap its voice cap on the MIDI thread; every transition is ramped.
+//
+// Down is fast: a smoothed load above STEP_DOWN_LOAD, or a single block
+// above PANIC_LOAD, costs one level, then the average gets SETTLE_S to
+// show what the new level costs before the next step. Up is slow: the
+// average must stay under STEP_UP_LOAD for the restore time. If a restored
+// level overloads again within its restore time the restore time doubles
+// (up to RESTORE_MAX_S), so a patch sitting on a threshold doesn't hunt;
+// a restore that lasts RESTORE_MAX_S resets it.
+//
+// Header-only, no Daisy dependencies. Update runs on the audio thread;
+// Level, Load and Steps may be read from the main loop.
+// =============================================================================
+
+#include <atomic>
+#include <cstdint>
+
+enum QualityLevel {
+    QUALITY_FULL,
+    QUALITY_FILTER_1X,
+    QUALITY_LEAN_FX,
+    QUALITY_DROP_VOICE,
+    QUALITY_DROP_VOICES,
+    QUALITY_NUM_LEVELS
+};
+
+class QualityGovernor {
+public:
+    static constexpr float STEP_DOWN_LOAD = 0.80f;  // of the block budget, smoothed
+    static constexpr float PANIC_LOAD     = 0.95f;  // one block
+    static constexpr float STEP_UP_LOAD   = 0.50f;  // smoothed
+    static constexpr float SMOOTH_S       = 0.05f;  // load average time constant
+    static constexpr float SETTLE_S       = 0.10f;  // after any step
+    static constexpr float RESTORE_S      = 2.0f;
+    static constexpr float RESTORE_MAX_S  = 32.0f;
+
+    // blocks_per_second: callback rate (sample rate / block size)
+    void Init(float blocks_per_second) {
+        smooth_ = 1.0f / (SMOOTH_S * blocks_per_second + 1.0f);
+        settle_blocks_  = Blocks(SETTLE_S, blocks_per_second);
+        restore_base_   = Blocks(RESTORE_S, blocks_per_second);
+        restore_max_    = Blocks(RESTORE_MAX_S, blocks_per_second);
+        restore_blocks_ = restore_base_;
+        avg_ = 0.0f;
+        hold_ = 0;
+        calm_ = 0;
+        since_restore_ = restore_max_;
+        level_.store(QUALITY_FULL, std::memory_order_relaxed);
+        load_.store(0.0f, std::memory_order_relaxed);
+        steps_.store(0, std::memory_order_relaxed);
+    }
+
+    // --- Audio thread ---
+
+    // used: this callback's time, budget: the time it may take (same units)
+    void Update(uint32_t used, uint32_t budget) {
+        float load = budget ? static_cast<float>(used) / static_cast<float>(budget) : 0.0f;
+        avg_ += smooth_ * (load - avg_);
+        load_.store(avg_, std::memory_order_relaxed);
+        if (hold_ > 0) hold_--;
+        if (since_restore_ < restore_max_) since_restore_++;
+        else restore_blocks_ = restore_base_;
+
+        int level = level_.load(std::memory_order_relaxed);
+        if ((load > PANIC_LOAD || avg_ > STEP_DOWN_LOAD) && hold_ == 0) {
+            if (level + 1 < QUALITY_NUM_LEVELS) {
+                if (since_restore_ < restore_blocks_ && restore_blocks_ < restore_max_)
+                    restore_blocks_ *= 2;
+                Step(level + 1);
+            }
+            calm_ = 0;
+            return;
+        }
+
+        calm_ = avg_ < STEP_UP_LOAD ? calm_ + 1 : 0;
+        if (level > QUALITY_FULL && calm_ >= restore_blocks_ && hold_ == 0) {
+            since_restore_ = 0;
+            calm_ = 0;
+            Step(level - 1);
+        }
+    }
+
+    // --- Any thread ---
+
+    int Level() const { return level_.load(std::memory_order_relaxed); }
+    float Load() const { return load_.load(std::memory_order_relaxed); }  // smoothed
+    uint32_t Steps() const { return steps_.load(std::memory_order_relaxed); }  // up or down
+
+private:
+    static uint32_t Blocks(float seconds, float blocks_per_second) {
+        return static_cast<uint32_t>(seconds * blocks_per_second + 0.5f);
+    }
+
+    void Step(int level) {
+        level_.store(level, std::memory_order_relaxed);
+        steps_.store(steps_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        hold_ = settle_blocks_;
+    }
+
+    float    smooth_;
+    float    avg_;
+    uint32_t settle_blocks_;
+    uint32_t restore_base_, restore_max_, restore_blocks_;
+    uint32_t hold_;            // blocks until the next step may happen
+    uint32_t calm_;            // consecutive blocks under STEP_UP_LOAD
+    uint32_t since_restore_;   // blocks since the last step up (saturates)
+
+    std::atomic<int>      level_;
+    std::atomic<float>    load_;
+    std::atomic<uint32_t> steps_;
+};
@@ -0,0 +1,235 @@
+#pragma once
+// =============================================================================
+// recorder.h — Streams the output to a 16-bit mono WAV through a double buffer
+// =============================================================================
+// The audio callback converts each block straight into one half of a
+// double buffer (Push). When a half fills, it is handed to the main loop
+// by a flag and the callback carries on in the other half. The main loop
+// writes a full half to storage from where it lies (Service), in WRITE_BYTES
+// pieces, and hands it back. Nothing is copied on the way. The audio
+// thread never waits: if both halves are still waiting for storage, the
+// block is dropped and counted.
+//
+// The file starts with a 512-byte header. A JUNK chunk pads the RIFF and
+// fmt chunks so the samples start on a sector boundary and every write
+// but the last is whole, aligned sectors. Stop() has the audio thread
+// close off the half it is filling; Service then writes the tail, patches
+// the sizes into the header and closes the sink.
+//
+// Sink is the storage: FatFS on the SD card in main.cpp, a plain file on
+// the host (test/recorder_test.cpp). It provides
+//
+//   bool Write(const uint8_t* data, uint32_t bytes)      append
+//   bool WriteAt(uint32_t offset, const uint8_t* data, uint32_t bytes)
+//   void Close()
+//
+// Header-only, no Daisy dependencies. Push runs on the audio thread;
+// everything else runs on the main loop.
+// =============================================================================
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+template <typename Sink>
+class Recorder {
+public:
+    static constexpr uint32_t HEADER_BYTES  = 512;
+    static constexpr uint32_t HALF_BYTES    = 32 * 1024;   // ~0.34 s at 48 kHz
+    static constexpr uint32_t WRITE_BYTES   = 8 * 1024;    // per Service call
+    static constexpr uint32_t HALF_SAMPLES  = HALF_BYTES / sizeof(int16_t);
+    static_assert(HALF_BYTES % WRITE_BYTES == 0 && WRITE_BYTES % 512 == 0,
+                  "writes must be whole sectors that tile a half");
+
+    // --- Main loop ---
+
+    // Writes the header and starts taking blocks. The sink must be open
+    // and empty. False if already recording or the header write fails.
+    bool Start(Sink& sink, uint32_t sample_rate) {
+        if (state_ != IDLE) return false;
+        sink_ = &sink;
+        sample_rate_ = sample_rate;
+        data_bytes_ = 0;
+        flush_half_ = 0;
+        flush_pos_ = 0;
+        write_errors_ = 0;
+        overruns_.store(0, std::memory_order_relaxed);
+        dropped_.store(0, std::memory_order_relaxed);
+        BuildHeader(0);
+        if (!sink.Write(header_, HEADER_BYTES)) {
+            write_errors_++;
+            sink.Close();
+            return false;
+        }
+        fill_half_ = 0;
+        fill_pos_ = 0;
+        tail_samples_ = 0;
+        full_[0].store(false, std::memory_order_relaxed);
+        full_[1].store(false, std::memory_order_relaxed);
+        stop_.store(false, std::memory_order_relaxed);
+        state_ = RECORDING;
+        run_.store(RUN_TAKING, std::memory_order_release);
+        return true;
+    }
+
+    // Ask the audio thread to close off the current half; Service finishes
+    // the file once it has
+    void Stop() {
+        if (state_ == RECORDING) stop_.store(true, std::memory_order_release);
+    }
+
+    // Write what the audio thread has handed over, at most WRITE_BYTES per
+    // call. Returns true while there is more to write right away; call it
+    // again after other work rather than waiting for the next handover.
+    bool Service() {
+        if (state_ == IDLE) return false;
+        int half = flush_half_;
+        if (full_[half].load(std::memory_order_acquire)) {
+            bool last = run_.load(std::memory_order_acquire) == RUN_DONE &&
+                        half == last_half_;
+            uint32_t bytes = last ? tail_samples_ * sizeof(int16_t) : HALF_BYTES;
+            uint32_t n = std::min(WRITE_BYTES, bytes - flush_pos_);
+            if (!n || sink_->Write(reinterpret_cast<const uint8_t*>(buf_[half]) + flush_pos_, n)) {
+                data_bytes_ += n;
+            } else {
+                write_errors_++;
+                stop_.store(true, std::memory_order_release);
+            }
+            flush_pos_ += n;
+            if (flush_pos_ >= bytes) {
+                flush_pos_ = 0;
+                flush_half_ ^= 1;
+                full_[half].store(false, std::memory_order_release);
+                if (last) Finish();
+            }
+            return state_ != IDLE;
+        }
+        return false;
+    }
+
+    bool Recording() const { return state_ != IDLE; }
+    uint32_t DataBytes() const { return data_bytes_; }       // written so far
+    uint32_t WriteErrors() const { return write_errors_; }
+
+    // --- Audio thread ---
+
+    // Convert n samples into the buffer. Returns true when it handed a
+    // half to the main loop (or finished after Stop): time to post a wake.
+    bool Push(const float* in, int n) {
+        int run = run_.load(std::memory_order_acquire);
+        if (run != RUN_TAKING) return false;
+        if (stop_.load(std::memory_order_acquire)) {
+            if (full_[fill_half_].load(std::memory_order_acquire)) {
+                // Both halves waiting: the newer one ends the file
+                last_half_ = fill_half_ ^ 1;
+                tail_samples_ = HALF_SAMPLES;
+            } else {
+                // Close off the half being filled, even if empty
+                last_half_ = fill_half_;
+                tail_samples_ = fill_pos_;
+                full_[fill_half_].store(true, std::memory_order_release);
+            }
+            run_.store(RUN_DONE, std::memory_order_release);
+            return true;
+        }
+        bool handed = false;
+        while (n > 0) {
+            if (full_[fill_half_].load(std::memory_order_acquire)) {
+                // Storage is behind on both halves: drop the rest of the block
+                overruns_.store(overruns_.load(std::memory_order_relaxed) + 1,
+                                std::memory_order_relaxed);
+                dropped_.store(dropped_.load(std::memory_order_relaxed) + n,
+                               std::memory_order_relaxed);
+                break;
+            }
+            int16_t* out = buf_[fill_half_] + fill_pos_;
+            uint32_t k = std::min(static_cast<uint32_t>(n), HALF_SAMPLES - fill_pos_);
+            for (uint32_t i = 0; i < k; i++) {
+                float x = std::max(-1.0f, std::min(1.0f, in[i]));
+                out[i] = static_cast<int16_t>(x * 32767.0f);
+            }
+            in += k;
+            n -= static_cast<int>(k);
+            fill_pos_ += k;
+            if (fill_pos_ == HALF_SAMPLES) {
+                full_[fill_half_].store(true, std::memory_order_release);
+                fill_half_ ^= 1;
+                fill_pos_ = 0;
+                handed = true;
+            }
+        }
+        return handed;
+    }
+
+    // --- Any thread ---
+
+    uint32_t Overruns() const { return overruns_.load(std::memory_order_relaxed); }  // blocks hit
+    uint32_t DroppedSamples() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    enum State { IDLE, RECORDING };
+    enum Run { RUN_OFF, RUN_TAKING, RUN_DONE };
+
+    void Finish() {
+        BuildHeader(data_bytes_);
+        if (!sink_->WriteAt(0, header_, HEADER_BYTES)) write_errors_++;
+        sink_->Close();
+        run_.store(RUN_OFF, std::memory_order_release);
+        state_ = IDLE;
+    }
+
+    static void Put16(uint8_t* p, uint32_t v) {
+        p[0] = static_cast<uint8_t>(v);
+        p[1] = static_cast<uint8_t>(v >> 8);
+    }
+    static void Put32(uint8_t* p, uint32_t v) {
+        Put16(p, v & 0xFFFF);
+        Put16(p + 2, v >> 16);
+    }
+
+    // RIFF, fmt (PCM, mono, 16-bit), JUNK up to 504, then the data chunk header
+    void BuildHeader(uint32_t data_bytes) {
+        uint8_t* h = header_;
+        std::memset(h, 0, HEADER_BYTES);
+        std::memcpy(h, "RIFF", 4);
+        Put32(h + 4, HEADER_BYTES - 8 + data_bytes);
+        std::memcpy(h + 8, "WAVEfmt ", 8);
+        Put32(h + 16, 16);
+        Put16(h + 20, 1);                          // PCM
+        Put16(h + 22, 1);                          // mono
+        Put32(h + 24, sample_rate_);
+        Put32(h + 28, sample_rate_ * sizeof(int16_t));
+        Put16(h + 32, sizeof(int16_t));            // block align
+        Put16(h + 34, 16);                         // bits
+        std::memcpy(h + 36, "JUNK", 4);
+        Put32(h + 40, HEADER_BYTES - 8 - 44);
+        std::memcpy(h + HEADER_BYTES - 8, "data", 4);
+        Put32(h + HEADER_BYTES - 4, data_bytes);
+    }
+
+    // Halves, written by Push and read by storage DMA in place. The header
+    // is a member, not on the stack, for the same DMA.
+    alignas(32) int16_t buf_[2][HALF_SAMPLES];
+    alignas(32) uint8_t header_[HEADER_BYTES];
+    std::atomic<bool> full_[2] = {};    // handed to the main loop, not yet written
+    std::atomic<int>  run_{RUN_OFF};
+    std::atomic<bool> stop_{false};
+    std::atomic<uint32_t> overruns_{0};
+    std::atomic<uint32_t> dropped_{0};
+
+    // Audio thread
+    int      fill_half_ = 0;
+    uint32_t fill_pos_ = 0;             // samples into the half being filled
+    int      last_half_ = 0;            // the half that ends the file, and
+    uint32_t tail_samples_ = 0;         // its samples, set at stop
+
+    // Main loop
+    State    state_ = IDLE;
+    Sink*    sink_ = nullptr;
+    uint32_t sample_rate_ = 0;
+    int      flush_half_ = 0;
+    uint32_t flush_pos_ = 0;            // bytes of the half written
+    uint32_t data_bytes_ = 0;
+    uint32_t write_errors_ = 0;
+};
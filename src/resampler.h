@@ -0,0 +1,189 @@
+#pragma once
+// =============================================================================
+// resampler.h — Polyphase halfband decimator/interpolator, ×2/×4 FX send
+// =============================================================================
+// The time-based FX don't need full bandwidth, so FxChain can run them at
+// 1/2 or 1/4 of the audio rate: FxResampler::Down filters and decimates the
+// send, the FX run on the short block, Up interpolates their sum back.
+// Each ×2 step is one halfband FIR in polyphase form — the decimator only
+// computes the outputs it keeps, the interpolator never multiplies the
+// zeros it stuffs — and ×4 is two steps in cascade.
+//
+// Header-only, no Daisy dependencies, no heap.
+// =============================================================================
+
+// Halfband low-pass, 39 taps, Kaiser window β = 6: ±0.01 dB up to 0.2·fs,
+// ≤ −60 dB from 0.3·fs (fs = the higher of the two rates). Every other tap
+// is zero apart from the 0.5 centre; the rest are symmetric, listed from
+// the centre out (±1, ±3, … ±19).
+constexpr int   HB_SIDE_TAPS = 10;
+constexpr int   HB_DELAY     = 19;   // group delay, samples at the higher rate
+constexpr float HB_COEFFS[HB_SIDE_TAPS] = {
+     0.31590412f, -0.09906631f,  0.05250956f, -0.03098541f,  0.01848699f,
+    -0.01064880f,  0.00570777f, -0.00271783f,  0.00105285f, -0.00024918f,
+};
+
+// Σ c_k (a[-k] + b[k]) over the ten side taps. Two partial sums so the
+// adds pipeline instead of each waiting on the last (FP adds don't
+// reassociate); same idea as Convolver::Fir.
+inline float HalfbandSides(const float* a, const float* b, int stride) {
+    float s0 = 0.0f, s1 = 0.0f;
+    for (int k = 0; k < HB_SIDE_TAPS; k += 2) {
+        s0 += HB_COEFFS[k]     * (a[-k * stride]       + b[k * stride]);
+        s1 += HB_COEFFS[k + 1] * (a[-(k + 1) * stride] + b[(k + 1) * stride]);
+    }
+    return s0 + s1;
+}
+
+// Most inputs a stage takes per Process call (FxChain::MAX_BLOCK)
+constexpr int HB_MAX_IN = 256;
+
+// ×2 decimator: one output per input pair. Polyphase: the centre tap only
+// ever sees even inputs and the side taps only odd ones, so the pairs are
+// split into two linear histories and each output is one contiguous
+// folded dot product — no ring wrap, no work for the dropped samples.
+class HalfbandDown {
+public:
+    void Reset() {
+        for (float& h : even_) h = 0.0f;
+        for (float& h : odd_) h = 0.0f;
+        pending_ = false;
+    }
+
+    // Consume n ≤ HB_MAX_IN inputs, write one output per completed pair;
+    // returns their count
+    int Process(const float* in, int n, float* out) {
+        // Pair p is (e[p], o[p]); an unpaired even input waits in e[pairs]
+        float* e = even_ + EVEN_KEEP;
+        float* o = odd_ + ODD_KEEP;
+        int i = 0, ne = 0, no = 0;
+        if (pending_ && n > 0) {
+            o[no++] = in[i++];
+            ne = 1;
+        }
+        for (; i + 1 < n; i += 2) {
+            e[ne++] = in[i];
+            o[no++] = in[i + 1];
+        }
+        if (i < n) e[ne++] = in[i];
+        for (int p = 0; p < no; p++)
+            out[p] = 0.5f * e[p - CENTRE] + HalfbandSides(o + p - CENTRE - 1, o + p - CENTRE, 1);
+        pending_ = ne > no;
+        for (int i = 0; i < EVEN_KEEP + (pending_ ? 1 : 0); i++) even_[i] = even_[no + i];
+        for (int i = 0; i < ODD_KEEP; i++) odd_[i] = odd_[no + i];
+        return no;
+    }
+
+private:
+    static constexpr int CENTRE    = (HB_DELAY - 1) / 2;   // pairs back to the centre tap
+    static constexpr int EVEN_KEEP = CENTRE;
+    static constexpr int ODD_KEEP  = 2 * CENTRE + 1;
+    float even_[EVEN_KEEP + HB_MAX_IN / 2 + 1];
+    float odd_[ODD_KEEP + HB_MAX_IN / 2];
+    bool  pending_;   // even_ holds an input still waiting for its pair
+};
+
+// ×2 interpolator: two outputs per input. Of the two polyphase branches one
+// is the centre tap alone (a pure delay), the other the ten folded pairs.
+class HalfbandUp {
+public:
+    void Reset() {
+        for (float& h : hist_) h = 0.0f;
+    }
+
+    // Consume n ≤ HB_MAX_IN inputs, write 2n outputs
+    void Process(const float* in, int n, float* out) {
+        float* x = hist_ + KEEP;
+        for (int i = 0; i < n; i++) x[i] = in[i];
+        for (int i = 0; i < n; i++) {
+            const float* w = x + i - KEEP;   // w[KEEP] newest
+            out[2 * i]     = 2.0f * HalfbandSides(w + HB_SIDE_TAPS - 1, w + HB_SIDE_TAPS, 1);
+            out[2 * i + 1] = w[HB_SIDE_TAPS];   // 2 · 0.5 · centre
+        }
+        for (int i = 0; i < KEEP; i++) hist_[i] = hist_[n + i];
+    }
+
+private:
+    static constexpr int KEEP = 2 * HB_SIDE_TAPS - 1;
+    float hist_[KEEP + HB_MAX_IN];
+};
+
+// Send → low rate → back, for factor 1, 2 or 4. Down and Up are separate
+// so the caller can process in between. Blocks of any length work: Up's
+// output goes through a FIFO primed with factor − 1 samples, which covers
+// the inputs still waiting for their decimated sample.
+class FxResampler {
+public:
+    static constexpr int MAX_FACTOR = 4;
+    static constexpr int FIFO_SIZE  = 512;   // ≥ MAX_FACTOR − 1 + FxChain::MAX_BLOCK
+
+    void Init(int factor) {
+        factor_ = factor == 4 ? 4 : factor == 2 ? 2 : 1;
+        Reset();
+    }
+
+    void Reset() {
+        for (HalfbandDown& d : down_) d.Reset();
+        for (HalfbandUp& u : up_) u.Reset();
+        for (float& f : fifo_) f = 0.0f;
+        read_ = 0;
+        write_ = factor_ - 1;
+    }
+
+    int Factor() const { return factor_; }
+
+    // Send-to-return delay at the audio rate, filters plus FIFO priming.
+    // ×4: the inner stage runs at half rate, so its delays count double.
+    int Latency() const {
+        if (factor_ == 1) return 0;
+        int filters = factor_ == 2 ? 2 * HB_DELAY : 2 * HB_DELAY + 2 * (2 * HB_DELAY);
+        return filters + factor_ - 1;
+    }
+
+    // n audio-rate samples in; returns the number of low-rate samples
+    // written to low (n / factor, ± 1 depending on the phase)
+    int Down(const float* in, int n, float* low) {
+        if (factor_ == 1) {
+            for (int i = 0; i < n; i++) low[i] = in[i];
+            return n;
+        }
+        if (factor_ == 2) return down_[0].Process(in, n, low);
+        int mid = down_[0].Process(in, n, scratch_);
+        return down_[1].Process(scratch_, mid, low);
+    }
+
+    // m low-rate samples in, then n audio-rate samples out. Over a block,
+    // pass Up the m that Down returned and the n that Down was given.
+    void Up(const float* low, int m, float* out, int n) {
+        if (factor_ == 1) {
+            for (int i = 0; i < n; i++) out[i] = low[i];
+            return;
+        }
+        float* hi = scratch_;
+        if (factor_ == 2) {
+            up_[0].Process(low, m, hi);
+        } else {
+            up_[1].Process(low, m, scratch2_);
+            up_[0].Process(scratch2_, 2 * m, hi);
+        }
+        for (int i = 0; i < factor_ * m; i++) {
+            fifo_[write_] = hi[i];
+            write_ = (write_ + 1) & (FIFO_SIZE - 1);
+        }
+        for (int i = 0; i < n; i++) {
+            out[i] = fifo_[read_];
+            read_ = (read_ + 1) & (FIFO_SIZE - 1);
+        }
+    }
+
+private:
+    static constexpr int SCRATCH = FIFO_SIZE;
+
+    int factor_ = 1;
+    HalfbandDown down_[2];   // [0] audio rate → /2, [1] /2 → /4
+    HalfbandUp   up_[2];     // [0] /2 → audio rate, [1] /4 → /2
+    float fifo_[FIFO_SIZE];
+    int   read_, write_;
+    float scratch_[SCRATCH];
+    float scratch2_[SCRATCH / 2];
+};
@@ -0,0 +1,53 @@
+// =============================================================================
+// reverb.cpp — 8-line FDN reverb implementation
+// =============================================================================
+
+#include "reverb.h"
+#include <cmath>
+#include <cstring>
+
+// Mutually prime line lengths at 48 kHz (33–72 ms), scaled to the actual rate
+static constexpr int LINE_LEN_48K[8] = {1597, 1861, 2113, 2381, 2647, 2903, 3187, 3457};
+
+bool Reverb::Init(float sample_rate, Arena& arena) {
+    float scale = sample_rate / 48000.0f;
+    bool ok = true;
+    for (int k = 0; k < NUM_LINES; k++) {
+        len_[k]  = static_cast<int>(LINE_LEN_48K[k] * scale);
+        line_[k] = arena.Alloc(len_[k]);
+        pos_[k]  = 0;
+        damp_[k] = 0.0f;
+        ok = ok && line_[k] != nullptr;
+    }
+    damp_coeff_ = 1.0f - std::exp(-2.0f * 3.14159265f * LP_HZ / sample_rate);
+    return ok;
+}
+
+void Reverb::Clear() {
+    for (int k = 0; k < NUM_LINES; k++) {
+        std::memset(line_[k], 0, len_[k] * sizeof(float));
+        damp_[k] = 0.0f;
+    }
+}
+
+void Reverb::ProcessBlock(const float* in, float* out, int n) {
+    for (int i = 0; i < n; i++) {
+        float x = in ? in[i] : 0.0f;
+
+        // Read the line outputs through the damping low-pass
+        float sum = 0.0f;
+        for (int k = 0; k < NUM_LINES; k++) {
+            damp_[k] += damp_coeff_ * (line_[k][pos_[k]] - damp_[k]);
+            sum += damp_[k];
+        }
+
+        // Householder feedback (I - 2/N·11ᵀ) is lossless; SIZE sets decay
+        float reflect = sum * (2.0f / NUM_LINES);
+        for (int k = 0; k < NUM_LINES; k++) {
+            line_[k][pos_[k]] = SIZE * (damp_[k] - reflect) + x;
+            if (++pos_[k] >= len_[k]) pos_[k] = 0;
+        }
+
+        out[i] = sum * 0.25f;
+    }
+}
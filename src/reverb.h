@@ -0,0 +1,35 @@
+#pragma once
+// =============================================================================
+// reverb.h — 8-line feedback delay network reverb (SPEC §6.2)
+// =============================================================================
+// Same topology family as DaisySP's ReverbSc (8 delay lines, damped
+// feedback), but with a Householder mixing matrix instead of modulated
+// taps, and delay lines drawn from an Arena so they can live in SDRAM.
+// Hardcoded 70% size, 4 kHz damping. Block-processed, no Daisy dependencies.
+// =============================================================================
+
+#include "arena.h"
+
+class Reverb {
+public:
+    // Returns false if the arena can't hold the delay lines
+    bool Init(float sample_rate, Arena& arena);
+
+    // Silence the lines (a stage put to sleep before its tail decayed)
+    void Clear();
+
+    // in → out (fully wet), n samples. in and out may alias. Pass
+    // in == nullptr to let the tail ring out with no new input.
+    void ProcessBlock(const float* in, float* out, int n);
+
+private:
+    static constexpr int   NUM_LINES = 8;
+    static constexpr float SIZE      = 0.7f;     // feedback gain
+    static constexpr float LP_HZ     = 4000.0f;  // damping in the loop
+
+    float* line_[NUM_LINES];
+    int    len_[NUM_LINES];
+    int    pos_[NUM_LINES];
+    float  damp_[NUM_LINES];   // one-pole LP state per line
+    float  damp_coeff_;
+};
@@ -0,0 +1,116 @@
+#pragma once
+// =============================================================================
+// spectrum.h — Output spectrum bars and scope trace for the OLED
+// =============================================================================
+// Turns the newest FFT_SIZE captured samples (capture_ring.h) into one frame
+// of the display's alternate views:
+//
+//   Spectrum  Hann window, RealFft, then NUM_BARS log-spaced bars from
+//             MIN_HZ to Nyquist. Each bar is the loudest bin in its band,
+//             RANGE_DB from the top of the display (a full-scale sine) to
+//             the bottom. Bars fall FALL_PX per frame, so peaks linger.
+//   Scope     SCOPE_W samples from the first rising zero crossing, so a
+//             steady note stands still.
+//
+// The work per frame is fixed: one window pass, one FFT_SIZE real FFT and
+// one pass over the bins, whatever the signal (host/bench: spectrum_frame).
+// Header-only, no Daisy dependencies. The window and FFT tables are
+// compile-time constants; Init only places the bars for the rate.
+// =============================================================================
+
+#include <cmath>
+#include <cstdint>
+#include "fft.h"
+
+// Periodic Hann window, built at compile time
+template <int N>
+struct HannWindow {
+    float w[N];
+};
+template <int N>
+constexpr HannWindow<N> MakeHannWindow() {
+    HannWindow<N> h{};
+    for (int i = 0; i < N; i++)
+        h.w[i] = static_cast<float>(0.5 - 0.5 * TurnCos(static_cast<double>(i) / N));
+    return h;
+}
+
+class Spectrum {
+public:
+    static constexpr int   FFT_SIZE = 1024;
+    static constexpr int   BINS     = FFT_SIZE / 2 + 1;
+    static constexpr int   NUM_BARS = 64;      // 2 px each across 128
+    static constexpr int   HEIGHT   = 64;      // bar heights 0–HEIGHT
+    static constexpr float MIN_HZ   = 30.0f;
+    static constexpr float RANGE_DB = 60.0f;
+    static constexpr int   FALL_PX  = 3;
+    static constexpr int   SCOPE_W  = 128;
+
+    // rate: the captured (decimated) sample rate
+    void Init(float rate) {
+        rate_ = rate;
+        // Band b covers bins [edge_[b], edge_[b+1]), at least one bin each
+        float top = 0.5f * rate;
+        for (int b = 0; b <= NUM_BARS; b++) {
+            float hz = MIN_HZ * std::pow(top / MIN_HZ, static_cast<float>(b) / NUM_BARS);
+            int bin = static_cast<int>(hz / rate * FFT_SIZE + 0.5f);
+            if (b > 0 && bin <= edge_[b - 1]) bin = edge_[b - 1] + 1;
+            edge_[b] = bin < BINS ? bin : BINS;
+        }
+        // Full-scale sine through the Hann window peaks at |X| = N/4
+        float ref = 0.25f * FFT_SIZE;
+        floor_power_ = ref * ref * std::pow(10.0f, -RANGE_DB / 10.0f);
+        for (uint8_t& h : heights_) h = 0;
+    }
+
+    // x: the newest FFT_SIZE samples, oldest first. Returns NUM_BARS heights.
+    const uint8_t* Analyze(const float* x) {
+        for (int i = 0; i < FFT_SIZE; i++) frame_[i] = x[i] * kWindow.w[i];
+        fft_.Forward(frame_, re_, im_);
+        float ref = 0.25f * FFT_SIZE;
+        float db_scale = HEIGHT / RANGE_DB;
+        for (int b = 0; b < NUM_BARS; b++) {
+            float peak = 0.0f;
+            for (int k = edge_[b]; k < edge_[b + 1]; k++) {
+                float p = re_[k] * re_[k] + im_[k] * im_[k];
+                if (p > peak) peak = p;
+            }
+            int h = 0;
+            if (peak > floor_power_) {
+                float db = 10.0f * std::log10(peak / (ref * ref));   // ≤ 0 below full scale
+                h = static_cast<int>(HEIGHT + db * db_scale);
+                h = h < 0 ? 0 : h > HEIGHT ? HEIGHT : h;
+            }
+            int fallen = heights_[b] - FALL_PX;
+            heights_[b] = static_cast<uint8_t>(h > fallen ? h : fallen > 0 ? fallen : 0);
+        }
+        return heights_;
+    }
+
+    // Bar under a frequency, −1 outside the display (the cutoff marker)
+    int BarForHz(float hz) const {
+        if (hz < MIN_HZ || hz >= 0.5f * rate_) return -1;
+        int b = static_cast<int>(NUM_BARS * std::log(hz / MIN_HZ) / std::log(0.5f * rate_ / MIN_HZ));
+        return b < NUM_BARS ? b : -1;
+    }
+
+    // x: the newest FFT_SIZE samples. Returns SCOPE_W samples starting at
+    // the first rising zero crossing in the older part (or the start).
+    static const float* Trace(const float* x) {
+        for (int i = 1; i < FFT_SIZE - SCOPE_W; i++)
+            if (x[i - 1] < 0.0f && x[i] >= 0.0f) return x + i;
+        return x + FFT_SIZE - SCOPE_W;
+    }
+
+private:
+    static constexpr HannWindow<FFT_SIZE> kWindow = MakeHannWindow<FFT_SIZE>();
+
+    RealFft<FFT_SIZE> fft_;
+    float   rate_ = 0.0f;
+    float   floor_power_ = 0.0f;
+    float   frame_[FFT_SIZE];
+    float   re_[BINS];
+    float   im_[BINS];
+    int     edge_[NUM_BARS + 1];
+    uint8_t heights_[NUM_BARS];
+};
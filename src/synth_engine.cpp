@@ -0,0 +1,161 @@
+// =============================================================================
+// synth_engine.cpp — MIDI dispatch and block rendering
+// =============================================================================
+
+#include "synth_engine.h"
+#include <algorithm>
+
+bool SynthEngine::Init(float sample_rate, Arena& fx_arena) {
+    for (int i = 0; i < NUM_VOICES; i++)
+        voices_[i].Init(sample_rate, static_cast<uint32_t>(i + 1));
+    allocator_.Init();
+    params_.SetSampleRate(sample_rate);
+    params_.Update();
+    mod_.Init(sample_rate);
+    quality_ = QUALITY_FULL;
+    fx_mix_ceiling_ = 1.0f;
+    fx_ceiling_step_ = 0.5f / (FX_CEILING_S * sample_rate);
+    scratch_.Init(scratch_mem_, FxChain::SCRATCH_FLOATS);
+    return fx_.Init(sample_rate, fx_arena, scratch_);
+}
+
+void SynthEngine::NoteOn(int note, int velocity) {
+    if (velocity == 0) {
+        NoteOff(note);
+        return;
+    }
+    int vi = allocator_.NoteOn(note);
+    voices_[vi].NoteOn(note, velocity);
+    mod_.NoteOn(vi);
+}
+
+void SynthEngine::NoteOff(int note) {
+    int vi = allocator_.NoteOff(note);
+    if (vi >= 0) voices_[vi].NoteOff(note);
+}
+
+void SynthEngine::ControlChange(int cc, int value) {
+    if (!params_.HandleCC(cc, value)) mod_.HandleCC(cc, value);
+}
+
+void SynthEngine::PitchBend(int value) {
+    params_.HandlePitchBend(value);
+}
+
+void SynthEngine::SetQuality(int level) {
+    level = level < QUALITY_FULL ? QUALITY_FULL
+          : level >= QUALITY_NUM_LEVELS ? QUALITY_NUM_LEVELS - 1 : level;
+    if (level == quality_) return;
+    quality_ = level;
+
+    for (int v = 0; v < NUM_VOICES; v++)
+        voices_[v].SetFilterOversampling(level < QUALITY_FILTER_1X);
+    fx_.SetTailBypass(level >= QUALITY_LEAN_FX);
+}
+
+void SynthEngine::ApplyVoiceCap(int level) {
+    int drop = level >= QUALITY_DROP_VOICE ? level - QUALITY_DROP_VOICE + 1 : 0;
+    int cap = NUM_VOICES - drop;
+    if (cap == allocator_.Limit()) return;
+    allocator_.SetLimit(cap);
+    for (int v = allocator_.Limit(); v < NUM_VOICES; v++) {
+        allocator_.Release(v);
+        voices_[v].Fade();
+    }
+}
+
+bool SynthEngine::AnyActive() const {
+    for (int v = 0; v < NUM_VOICES; v++)
+        if (voices_[v].IsActive()) return true;
+    return false;
+}
+
+Korg35LPF::NewtonStats SynthEngine::TakeFilterStats() {
+    Korg35LPF::NewtonStats acc;
+    for (int v = 0; v < NUM_VOICES; v++) voices_[v].TakeFilterStats(acc);
+    return acc;
+}
+
+// ---------------------------------------------------------------------------
+// Render graph (audio_graph.h)
+// ---------------------------------------------------------------------------
+
+struct SynthEngine::VoiceSum {
+    static constexpr ProfStage PROFILE = PROF_VOICES;
+    static void Run(SynthEngine& e, float* out, int n) {
+        for (int i = 0; i < n; i++) out[i] = 0.0f;
+        if (!e.mod_.Running()) {
+            e.mod_.Tick(n);   // keep LFOs and mod envelopes moving
+            for (int v = 0; v < NUM_VOICES; v++)
+                e.voices_[v].ProcessBlock(e.params_, out, n);
+            return;
+        }
+        for (int off = 0; off < n; off += MOD_INTERVAL) {
+            int k = n - off < MOD_INTERVAL ? n - off : MOD_INTERVAL;
+            e.mod_.Tick(k);
+            for (int v = 0; v < NUM_VOICES; v++)
+                e.voices_[v].ProcessBlock(e.params_, e.mod_.ForVoice(v), out + off, k);
+        }
+    }
+};
+
+struct SynthEngine::VoiceMix {
+    static constexpr bool POINTWISE = true;
+    static constexpr ProfStage PROFILE = PROF_VOICES;
+    explicit VoiceMix(const SynthEngine&) {}
+    float operator()(float x) const { return x * (1.0f / NUM_VOICES); }
+};
+
+struct SynthEngine::Drive {
+    static constexpr ProfStage PROFILE = PROF_FX_DRIVE;
+    static void Run(SynthEngine& e, float* buf, int n) {
+        bool cab_ir = e.params_.cab_ir && e.quality_ < QUALITY_LEAN_FX;
+        e.fx_.ProcessBlock(buf, n, e.params_.overdrive, cab_ir);
+    }
+};
+
+struct SynthEngine::Space {
+    static constexpr ProfStage PROFILE = PROF_FX_SPACE;
+    static void Run(SynthEngine& e, float* buf, int n) {
+        // Lean: the mix ceiling slides to 0.5 (pure chorus), one block's
+        // worth at a time, so the reverb fades rather than cuts
+        float target = e.quality_ >= QUALITY_LEAN_FX ? 0.5f : 1.0f;
+        float step = e.fx_ceiling_step_ * static_cast<float>(n);
+        float& c = e.fx_mix_ceiling_;
+        c = c > target ? std::max(target, c - step) : std::min(target, c + step);
+        e.fx_.ProcessSpace(buf, n, std::min(e.params_.fx_mix, c));
+    }
+};
+
+struct SynthEngine::OutputGain {
+    static constexpr bool POINTWISE = true;
+    static constexpr ProfStage PROFILE = PROF_OUTPUT;
+    explicit OutputGain(const SynthEngine& e) : gain(e.params_.output_gain) {}
+    float operator()(float x) const { return x * gain; }
+    float gain;
+};
+
+void SynthEngine::Process(float* out, int n, float* mirror) {
+    params_.Advance(n);
+
+    // Every voice and FX stage asleep: the graph would render zeros. Only
+    // the modulation clock keeps running, ticked the way VoiceSum does.
+    if (!AnyActive() && !FxAwake()) {
+        if (!mod_.Running()) mod_.Tick(n);
+        else
+            for (int off = 0; off < n; off += MOD_INTERVAL)
+                mod_.Tick(n - off < MOD_INTERVAL ? n - off : MOD_INTERVAL);
+        for (int i = 0; i < n; i++) out[i] = 0.0f;
+        if (mirror)
+            for (int i = 0; i < n; i++) mirror[i] = 0.0f;
+        return;
+    }
+
+    while (n > 0) {
+        int chunk = n < FxChain::MAX_BLOCK ? n : FxChain::MAX_BLOCK;
+        RenderGraph::Run(*this, out, chunk, mirror);
+        out += chunk;
+        if (mirror) mirror += chunk;
+        n -= chunk;
+    }
+}
@@ -0,0 +1,99 @@
+#pragma once
+// =============================================================================
+// synth_engine.h — Voices + allocator + params + FX, driven by MIDI events
+// =============================================================================
+// Everything between "a MIDI message arrived" and "here is a block of mono
+// audio", with no Daisy dependencies. main.cpp wraps it with the codec, UART
+// and USB; the host tools in host/ drive it from MIDI files.
+// =============================================================================
+
+#include "voice.h"
+#include "voice_allocator.h"
+#include "mod_engine.h"
+#include "fx_chain.h"
+#include "params.h"
+#include "arena.h"
+#include "audio_graph.h"
+#include "cycle_profiler.h"
+#include "quality_governor.h"
+
+class SynthEngine {
+public:
+    static constexpr int NUM_VOICES = 4;
+
+    // FX delay lines are taken from the arena. Returns false if it's too small.
+    // Per-block temporaries come from the engine's own scratch arena.
+    bool Init(float sample_rate, Arena& fx_arena);
+
+    // MIDI handlers (channel filtering is the caller's job)
+    void NoteOn(int note, int velocity);   // velocity 0 is treated as NoteOff
+    void NoteOff(int note);
+    void ControlChange(int cc, int value);
+    void PitchBend(int value);             // 14-bit, center 8192
+
+    // True if any voice slot holds a pressed key
+    bool AnyGated() const { return allocator_.AnyGated(); }
+
+    // True if any voice is still sounding (held, or in a release tail that
+    // hasn't gone to sleep yet)
+    bool AnyActive() const;
+
+    // True if any FX stage is still running (drive, chorus or reverb)
+    bool FxAwake() const { return fx_.DriveAwake() || fx_.ChorusAwake() || fx_.ReverbAwake(); }
+
+    // Render n mono samples (voice sum → overdrive → chorus/reverb → gain).
+    // mirror, if given, gets the same samples: the codec's other channel,
+    // written by the last stage's loop rather than a separate copy.
+    void Process(float* out, int n, float* mirror = nullptr);
+
+    // Render quality (quality_governor.h), applied from the next block:
+    // filter oversampling and the FX. Call from the thread that renders.
+    // The reverb is faded out over FX_CEILING_S.
+    void SetQuality(int level);
+    int Quality() const { return quality_; }
+
+    // The voice cap for a quality level. Call from the thread that handles
+    // MIDI, before it handles MIDI: the allocator is that thread's. Voices
+    // over a lowered cap fade out in Voice::FADE_S.
+    void ApplyVoiceCap(int level);
+
+    Params& GetParams() { return params_; }
+    const Params& GetParams() const { return params_; }
+
+    // LFOs, mod envelopes and their CC routing (CCs 20–28)
+    const ModEngine<NUM_VOICES>& GetMod() const { return mod_; }
+
+    // Newton-Raphson filter counters over all voices since the last call
+    // (CC 11 mode; Average() is iterations per oversampled filter tick).
+    // Call from the thread that renders.
+    Korg35LPF::NewtonStats TakeFilterStats();
+
+    // Per-stage cycle counts (empty unless built with MS20_PROFILE=1). The
+    // caller owning the audio callback adds PROF_CALLBACK and calls EndBlock().
+    CycleProfiler& GetProfiler() { return profiler_; }
+
+private:
+    // Render graph stages, in order (synth_engine.cpp)
+    struct VoiceSum;     // all voices into the block
+    struct VoiceMix;     // × 1/NUM_VOICES
+    struct Drive;        // FxChain::ProcessBlock
+    struct Space;        // FxChain::ProcessSpace
+    struct OutputGain;   // × params.output_gain
+    using RenderGraph = AudioGraph<SynthEngine, VoiceSum, VoiceMix, Drive, Space, OutputGain>;
+
+    static constexpr float FX_CEILING_S = 0.05f;   // reverb fade for QUALITY_LEAN_FX
+
+    Voice voices_[NUM_VOICES];
+    VoiceAllocator<NUM_VOICES> allocator_;
+    Params params_;
+    ModEngine<NUM_VOICES> mod_;
+    FxChain fx_;
+    CycleProfiler profiler_;
+
+    int   quality_;
+    float fx_mix_ceiling_;        // fx_mix limit, slews to 0.5 (chorus) when lean
+    float fx_ceiling_step_;       // per sample
+
+    float        scratch_mem_[FxChain::SCRATCH_FLOATS];
+    ScratchArena scratch_;
+};
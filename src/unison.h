@@ -0,0 +1,83 @@
+#pragma once
+// =============================================================================
+// unison.h — Stack of 2–8 detuned PolyBLEP saws, rendered lane by lane
+// =============================================================================
+// Voice's saw in unison mode (CC 12 count, CC 13 detune). The lanes are kept
+// as structure-of-arrays and every lane runs the same branch-free sequence:
+//
+//   phase   uint32 accumulator; wraps by overflow, no compare
+//   t       phase · 2⁻³², the 0–1 position
+//   blep    max(0, 1 − t/d)² and max(0, 1 − (1 − t)/d)²: the two PolyBLEP
+//           halves, each zero away from its side of the wrap, so no
+//           branches and no per-lane divide (1/d comes in per sample)
+//
+// The Seed's M7 has no float SIMD, so the lanes are a tight scalar loop
+// with no data-dependent branches rather than vector registers: the cost
+// grows by one lane's worth per saw (host/bench: unison_N, "M7 unison").
+//
+// Lanes are spread symmetrically over ±detune cents and start at spread
+// phases, so the stack doesn't begin with every wrap lined up. They run
+// free across notes like the plain saw. Header-only, no Daisy dependencies.
+// =============================================================================
+
+#include <cmath>
+#include <cstdint>
+
+class UnisonStack {
+public:
+    static constexpr int MAX_LANES = 8;
+
+    // seed: spreads the start phases (differs per voice)
+    void Init(uint32_t seed) {
+        for (int l = 0; l < MAX_LANES; l++) {
+            seed = seed * 1664525u + 1013904223u;
+            phase_[l] = seed;
+            ratio_[l] = 1.0f;
+            inv_ratio_[l] = 1.0f;
+        }
+        count_ = 0;
+        detune_ = -1.0f;
+        gain_ = 1.0f;
+    }
+
+    // Lane count (2–MAX_LANES) and spread (± cents at the outer lanes).
+    // Cheap when nothing changed: call once per block.
+    void Configure(int count, float detune_cents) {
+        if (count == count_ && detune_cents == detune_) return;
+        count_ = count < 1 ? 1 : count > MAX_LANES ? MAX_LANES : count;
+        detune_ = detune_cents;
+        for (int l = 0; l < count_; l++) {
+            float pos = count_ > 1 ? 2.0f * l / (count_ - 1) - 1.0f : 0.0f;
+            ratio_[l] = std::exp2(pos * detune_cents / 1200.0f);
+            inv_ratio_[l] = 1.0f / ratio_[l];
+        }
+        // Lanes at different pitches add up by power, not amplitude
+        gain_ = 1.0f / std::sqrt(static_cast<float>(count_));
+    }
+
+    int Count() const { return count_; }
+
+    // One output sample. dt: the centre pitch's phase increment per sample
+    // (< 0.5 / the widest ratio), inv_dt: 1 / dt.
+    float Next(float dt, float inv_dt) {
+        float sum = 0.0f;
+        for (int l = 0; l < count_; l++) {
+            float d = dt * ratio_[l];
+            float inv_d = inv_dt * inv_ratio_[l];
+            phase_[l] += static_cast<uint32_t>(d * 4294967296.0f);
+            float t = static_cast<float>(phase_[l]) * (1.0f / 4294967296.0f);
+            float head = std::fmax(0.0f, 1.0f - t * inv_d);            // just after the wrap
+            float tail = std::fmax(0.0f, 1.0f - (1.0f - t) * inv_d);   // just before it
+            sum += 2.0f * t - 1.0f + head * head - tail * tail;
+        }
+        return sum * gain_;
+    }
+
+private:
+    uint32_t phase_[MAX_LANES];
+    float    ratio_[MAX_LANES];       // lane pitch / centre pitch
+    float    inv_ratio_[MAX_LANES];
+    int      count_;
+    float    detune_;
+    float    gain_;
+};
@@ -19,11 +19,12 @@ static float MidiToFreq(int note) {
 // -------------------------------------------------------------------------
 // Init
 // -------------------------------------------------------------------------
-void Voice::Init(float sample_rate) {
+void Voice::Init(float sample_rate, uint32_t seed) {
     sr_ = sample_rate;
     inv_sr_ = 1.0f / sample_rate;
 
     saw_phase_ = 0.0f;
+    unison_.Init(seed);
     sub_phase_ = 0.0f;
     note_freq_ = 440.0f;
     midi_note_ = 69;
@@ -34,8 +35,16 @@ void Voice::Init(float sample_rate) {
     env_value_ = 0.0f;
     filt_env_stage_ = kRelease;
     filt_env_value_ = 0.0f;
+    fading_ = false;
+    quiet_samples_ = 0;
+    sleep_hold_samples_ = static_cast<int>(SLEEP_HOLD_S * sample_rate + 0.5f);
 
     filter_.Init(sample_rate);
+
+    attack_coeff_ = OnePoleCoeff(ENV_ATTACK_S);
+    fade_coeff_ = OnePoleCoeff(FADE_S);
+    key_track_ = 1.0f;
+    cache_ = {2.0f, 1.0f, -1.0f, 0.0f, -1.0f, 0.0f, -1.0f};  // all stale
 }
 
 // -------------------------------------------------------------------------
@@ -45,7 +54,10 @@ void Voice::NoteOn(int midi_note, int velocity) {
     midi_note_ = midi_note;
     note_freq_ = MidiToFreq(midi_note);
     velocity_ = static_cast<float>(velocity) / 127.0f;
+    key_track_ = std::pow(2.0f, KEY_TRACKING * static_cast<float>(midi_note - 60) / 12.0f);
     gate_ = true;
+    fading_ = false;
+    quiet_samples_ = 0;
     env_stage_ = kAttack;
     filt_env_stage_ = kAttack;
 
@@ -59,6 +71,17 @@ void Voice::NoteOff(int midi_note) {
     }
 }
 
+void Voice::Fade() {
+    gate_ = false;
+    fading_ = true;
+}
+
+void Voice::SetFilterOversampling(bool on) {
+    int before = filter_.Oversample();
+    filter_.SetOversampling(on);
+    if (filter_.Oversample() != before) cache_.cutoff_hz = -1.0f;  // g is per internal rate
+}
+
 // -------------------------------------------------------------------------
 // PolyBLEP — antialiasing residual for the saw discontinuity
 // -------------------------------------------------------------------------
@@ -79,7 +102,10 @@ float Voice::PolyBlep(float t, float dt) {
 // -------------------------------------------------------------------------
 float Voice::Wavefold(float in, float amount) {
     if (amount < 0.001f) return in;
+    return FoldTriangle(in, amount);
+}
 
+float Voice::FoldTriangle(float in, float amount) {
     // Gain stage: 1x at 0%, 6x at 100%
     float gained = in * (1.0f + amount * 5.0f);
 
@@ -116,15 +142,37 @@ float Voice::ProcessEnvelope(float attack_s, float decay_s, float sustain, float
         time_s = release_s;
     }
 
+    float coeff = OnePoleCoeff(time_s);
+
+    value += coeff * (target - value);
+    return value;
+}
+
+float Voice::OnePoleCoeff(float time_s) const {
     // One-pole coefficient: 1 - e^(-1 / (time * sr))
     // Clamped to avoid div-by-zero for very short times
-    float coeff;
-    if (time_s < 0.001f) {
-        coeff = 1.0f;
+    if (time_s < 0.001f) return 1.0f;
+    return 1.0f - std::exp(-inv_sr_ / time_s);
+}
+
+// Same stage logic as ProcessEnvelope, with the coefficients precomputed
+inline float Voice::StepEnvelope(const EnvCoeffs& c, float sustain,
+                                 EnvStage& stage, float& value) {
+    float target, coeff;
+    if (gate_) {
+        if (stage == kAttack) {
+            target = 1.0f;
+            coeff = c.attack;
+            if (value >= 0.999f) stage = kDecay;
+        } else {
+            target = sustain;
+            coeff = c.decay;
+        }
     } else {
-        coeff = 1.0f - std::exp(-inv_sr_ / time_s);
+        stage = kRelease;
+        target = 0.0f;
+        coeff = c.release;
     }
-
     value += coeff * (target - value);
     return value;
 }
@@ -134,16 +182,23 @@ float Voice::ProcessEnvelope(float attack_s, float decay_s, float sustain, float
 // -------------------------------------------------------------------------
 float Voice::Process(const Params& p) {
     if (!IsActive()) return 0.0f;
+    cache_.cutoff_hz = -1.0f;  // the filter cutoff is set per sample below
 
     // --- Pitch with pitch bend ---
     float freq = note_freq_ * std::pow(2.0f, p.pitch_bend * PITCH_BEND_RANGE / 12.0f);
     float dt = freq * inv_sr_;  // phase increment for main osc
 
-    // --- Saw oscillator (PolyBLEP antialiased) ---
-    saw_phase_ += dt;
-    if (saw_phase_ >= 1.0f) saw_phase_ -= 1.0f;
-    float saw = 2.0f * saw_phase_ - 1.0f;       // naive saw: -1 to +1
-    saw -= PolyBlep(saw_phase_, dt);              // apply antialiasing
+    // --- Saw oscillator (PolyBLEP antialiased), or the unison stack ---
+    float saw;
+    if (p.unison > 1) {
+        unison_.Configure(p.unison, p.unison_detune);
+        saw = unison_.Next(dt, 1.0f / dt);
+    } else {
+        saw_phase_ += dt;
+        if (saw_phase_ >= 1.0f) saw_phase_ -= 1.0f;
+        saw = 2.0f * saw_phase_ - 1.0f;           // naive saw: -1 to +1
+        saw -= PolyBlep(saw_phase_, dt);          // apply antialiasing
+    }
 
     // --- Sub oscillator (sine, -1 octave) ---
     float sub_dt = dt * 0.5f;
@@ -164,6 +219,7 @@ float Voice::Process(const Params& p) {
     // depth=0: gate (sustain=1, instant release). depth=1: full AD envelope.
     float sustain = 1.0f - p.amp_env_depth;
     float release = std::max(0.002f, p.amp_env_depth * p.decay_time);
+    if (fading_) release = std::min(release, FADE_S);
     float env = ProcessEnvelope(ENV_ATTACK_S, p.decay_time, sustain, release,
                                 env_stage_, env_value_);
 
@@ -194,6 +250,7 @@ float Voice::Process(const Params& p) {
 
     filter_.SetCutoff(mod_cutoff);
     filter_.SetResonance(p.resonance);
+    filter_.SetAccurate(p.filter_nr);
 
     float filtered = filter_.Process(folded);
 
@@ -202,3 +259,181 @@ float Voice::Process(const Params& p) {
 
     return filtered * amp;
 }
+
+// -------------------------------------------------------------------------
+// Block kernels
+// -------------------------------------------------------------------------
+// One instantiation per feature mask. Every expression that survives keeps
+// the operation order of Process(), so a kernel is bit-exact with the
+// reference path — disabled features contributed exact zeros / ones there.
+// The sub phase keeps running with the sub off so turning it on later lands
+// where the reference would; only the sin() is skipped.
+
+unsigned Voice::FeatureMask(const Params& p) const {
+    unsigned f = 0;
+    if (p.fold_amount >= 0.001f)   f |= kFold;
+    if (p.sub_level > 0.0f)        f |= kSub;
+    if (p.filt_env_depth > 0.0f)   f |= kFiltEnv;
+    return f;
+}
+
+unsigned Voice::FeatureMask(const Params& p, const VoiceMod& m) const {
+    unsigned f = FeatureMask(p) & ~kFold;
+    if (ModFold(p, m) >= 0.001f)   f |= kFold;
+    return f;
+}
+
+// Fold amount with the modulation offset; untouched when there is none
+float Voice::ModFold(const Params& p, const VoiceMod& m) {
+    if (m.fold == 0.0f) return p.fold_amount;
+    return std::clamp(p.fold_amount + m.fold, 0.0f, 1.0f);
+}
+
+template <unsigned F>
+void Voice::RenderBlock(const Params& p, const VoiceMod& m, float* out, int n) {
+    constexpr bool FOLD     = F & kFold;
+    constexpr bool SUB      = F & kSub;
+    constexpr bool FILT_ENV = F & kFiltEnv;
+
+    // --- Per-block: Params and the note can't change inside a block ---
+    if (p.pitch_bend != cache_.bend) {
+        cache_.bend = p.pitch_bend;
+        cache_.bend_mult = std::pow(2.0f, p.pitch_bend * PITCH_BEND_RANGE / 12.0f);
+    }
+    float freq = note_freq_ * cache_.bend_mult;
+    float dt = freq * inv_sr_;
+
+    // Modulation ramps, advanced before each sample so the last one lands
+    // on the _to value. Without modulation the steps are exactly zero and
+    // the multipliers exactly one, which leaves every value bit-identical.
+    float inv_n = 1.0f / static_cast<float>(n);
+    float dt_step = (dt * m.pitch_to - dt * m.pitch_from) * inv_n;
+    dt *= m.pitch_from;
+    float cut_mult = m.cutoff_from;
+    float cut_step = (m.cutoff_to - m.cutoff_from) * inv_n;
+    float fold = ModFold(p, m);
+
+    // Unison: 1/dt per block, or per sample while the pitch ramps
+    bool stack = p.unison > 1;
+    float inv_dt = 0.0f;
+    if (stack) {
+        unison_.Configure(p.unison, p.unison_detune);
+        inv_dt = 1.0f / (dt + dt_step);
+    }
+
+    float sustain = 1.0f - p.amp_env_depth;
+    float release = std::max(0.002f, p.amp_env_depth * p.decay_time);
+    if (p.decay_time != cache_.decay_s) {
+        cache_.decay_s = p.decay_time;
+        cache_.decay_coeff = OnePoleCoeff(p.decay_time);
+    }
+    if (release != cache_.release_s) {
+        cache_.release_s = release;
+        cache_.release_coeff = OnePoleCoeff(release);
+    }
+    EnvCoeffs amp_c  = {attack_coeff_, cache_.decay_coeff,
+                        fading_ ? std::max(cache_.release_coeff, fade_coeff_) : cache_.release_coeff};
+    EnvCoeffs filt_c = {attack_coeff_, cache_.decay_coeff, cache_.decay_coeff};
+
+    float key_cutoff = p.cutoff_hz * key_track_;
+    key_cutoff *= 0.75f + 0.25f * velocity_;
+    float headroom = std::max(0.0f, 10000.0f - key_cutoff);
+
+    filter_.SetResonance(p.resonance);
+    filter_.SetAccurate(p.filter_nr);
+    float g = 0.0f, g_step = 0.0f;   // cutoff ramp for the static-cutoff kernels
+    if (FILT_ENV) {
+        cache_.cutoff_hz = -1.0f;
+    } else if (m.cutoff_from != 1.0f || m.cutoff_to != 1.0f) {
+        // One tan() per block: ramp g itself towards the modulated target
+        cache_.cutoff_hz = -1.0f;
+        g = filter_.Coeff();
+        float target = std::clamp(key_cutoff * m.cutoff_to, 5.0f, sr_ * 0.49f);
+        g_step = (filter_.CutoffCoeff(target) - g) * inv_n;
+    } else {
+        float cutoff = std::clamp(key_cutoff, 5.0f, sr_ * 0.49f);
+        if (cutoff != cache_.cutoff_hz) {
+            cache_.cutoff_hz = cutoff;
+            filter_.SetCutoff(cutoff);
+        }
+        g = filter_.Coeff();
+    }
+
+    float peak = 0.0f;
+    for (int i = 0; i < n; i++) {
+        if (!IsActive()) break;  // released and faded out mid-block
+
+        dt += dt_step;
+        float sub_dt = dt * 0.5f;
+        float saw;
+        if (stack) {
+            if (dt_step != 0.0f) inv_dt = 1.0f / dt;
+            saw = unison_.Next(dt, inv_dt);
+        } else {
+            saw_phase_ += dt;
+            if (saw_phase_ >= 1.0f) saw_phase_ -= 1.0f;
+            saw = 2.0f * saw_phase_ - 1.0f;
+            saw -= PolyBlep(saw_phase_, dt);
+        }
+
+        sub_phase_ += sub_dt;
+        if (sub_phase_ >= 1.0f) sub_phase_ -= 1.0f;
+        float mix = saw;
+        if (SUB) mix = saw + std::sin(2.0f * static_cast<float>(M_PI) * sub_phase_) * p.sub_level;
+
+        mix *= velocity_;
+        float folded = FOLD ? FoldTriangle(mix, fold) : mix;
+
+        float env  = StepEnvelope(amp_c, sustain, env_stage_, env_value_);
+        float fenv = StepEnvelope(filt_c, 0.0f, filt_env_stage_, filt_env_value_);
+
+        if (FILT_ENV) {
+            float filt_env = fenv * fenv;
+            float mod_cutoff = key_cutoff + filt_env * p.filt_env_depth * headroom;
+            cut_mult += cut_step;
+            mod_cutoff *= cut_mult;
+            filter_.SetCutoff(std::clamp(mod_cutoff, 5.0f, sr_ * 0.49f));
+        } else {
+            g += g_step;
+            filter_.SetCoeff(g);
+        }
+
+        float y = filter_.Process(folded) * env;
+        peak = std::max(peak, std::fabs(y));
+        out[i] += y;
+    }
+    CheckSilence(peak, n);
+}
+
+void Voice::CheckSilence(float peak, int n) {
+    if (gate_ || peak >= SLEEP_THRESHOLD) {
+        quiet_samples_ = 0;
+        return;
+    }
+    quiet_samples_ += n;
+    if (quiet_samples_ < sleep_hold_samples_) return;
+    // Sleep: retriggers start from rest, as after a long silence
+    env_stage_ = kRelease;
+    env_value_ = 0.0f;
+    filt_env_stage_ = kRelease;
+    filt_env_value_ = 0.0f;
+    filter_.Reset();
+    quiet_samples_ = 0;
+}
+
+const Voice::Kernel Voice::kKernels[kNumKernels] = {
+    &Voice::RenderBlock<0>, &Voice::RenderBlock<1>, &Voice::RenderBlock<2>,
+    &Voice::RenderBlock<3>, &Voice::RenderBlock<4>, &Voice::RenderBlock<5>,
+    &Voice::RenderBlock<6>, &Voice::RenderBlock<7>,
+};
+
+void Voice::ProcessBlock(const Params& p, float* out, int n) {
+    static const VoiceMod kNoMod;
+    if (!IsActive()) return;
+    (this->*kKernels[FeatureMask(p)])(p, kNoMod, out, n);
+}
+
+void Voice::ProcessBlock(const Params& p, const VoiceMod& m, float* out, int n) {
+    if (!IsActive()) return;
+    (this->*kKernels[FeatureMask(p, m)])(p, m, out, n);
+}
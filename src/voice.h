@@ -5,10 +5,13 @@
 
 #include "ms20_filter.h"
 #include "params.h"
+#include "mod_engine.h"
+#include "unison.h"
 
 class Voice {
 public:
-    void Init(float sample_rate);
+    // seed spreads the unison saws' start phases; give each voice its own
+    void Init(float sample_rate, uint32_t seed = 1);
 
     // Trigger a new note (velocity 0–127)
     void NoteOn(int midi_note, int velocity);
@@ -16,11 +19,58 @@ public:
     // Release the current note (only if note matches)
     void NoteOff(int midi_note);
 
+    // Release whatever is playing within about FADE_S, however long the
+    // patch's release is (voice cap lowered by the quality governor)
+    void Fade();
+
+    // 2x filter oversampling on (default) or off (QUALITY_FILTER_1X)
+    void SetFilterOversampling(bool on);
+
     // Process one sample. Reads parameters from the provided Params struct.
+    // Reference path: everything is evaluated every sample.
     float Process(const Params& p);
 
+    // Render n samples and add them into out. Same output as n Process()
+    // calls, but through a kernel specialised for the features the current
+    // Params use, with per-block values (pitch, envelope coefficients, and
+    // the filter cutoff when nothing modulates it) hoisted out of the loop.
+    // Unison has no feature bit: the saw or the stack is picked per sample
+    // on a flag that is constant for the block, rather than doubling the
+    // kernels.
+    void ProcessBlock(const Params& p, float* out, int n);
+
+    // Same, with control-rate modulation: pitch and cutoff ramp from the
+    // _from to the _to multipliers across the n samples, fold is offset.
+    // An identity VoiceMod renders exactly like the overload above.
+    void ProcessBlock(const Params& p, const VoiceMod& m, float* out, int n);
+
+    // Feature bits selecting a block kernel. Velocity → cutoff has no bit:
+    // it is folded into the per-block cutoff, so a kernel for it would only
+    // double the flash spent on kernels.
+    enum Feature : unsigned {
+        kFold    = 1u << 0,   // wavefolder (fold_amount ≥ 0.001)
+        kSub     = 1u << 1,   // sine sub (sub_level > 0)
+        kFiltEnv = 1u << 2,   // filter envelope → cutoff (filt_env_depth > 0)
+        kNumKernels = 1u << 3
+    };
+    unsigned FeatureMask(const Params& p) const;
+    unsigned FeatureMask(const Params& p, const VoiceMod& m) const;
+
     bool IsActive() const { return gate_ || env_value_ > 1e-6f; }
 
+    static constexpr float FADE_S = 0.01f;
+
+    // Block path only: a released voice whose output peak stays under
+    // SLEEP_THRESHOLD (−80 dBFS) for SLEEP_HOLD_S of blocks goes to sleep.
+    // Its envelopes and filter are zeroed, so IsActive() is false and it
+    // costs nothing until the next NoteOn. Long one-pole release tails
+    // would otherwise run for seconds below anything audible.
+    static constexpr float SLEEP_THRESHOLD = 1e-4f;
+    static constexpr float SLEEP_HOLD_S    = 0.016f;
+
+    // Filter's Newton-Raphson counters (CC 11 mode), added to acc and cleared
+    void TakeFilterStats(Korg35LPF::NewtonStats& acc) { filter_.TakeNewtonStats(acc); }
+
 private:
     enum EnvStage { kAttack, kDecay, kRelease };
 
@@ -29,6 +79,25 @@ private:
 
     // Wavefolder: symmetric, stateless
     float Wavefold(float in, float amount);
+    static float FoldTriangle(float in, float amount);
+    static float ModFold(const Params& p, const VoiceMod& m);
+
+    // One-pole envelope coefficients per stage, fixed for a block
+    struct EnvCoeffs {
+        float attack, decay, release;
+    };
+    float OnePoleCoeff(float time_s) const;
+    float StepEnvelope(const EnvCoeffs& c, float sustain, EnvStage& stage, float& value);
+
+    // After a block with this output peak: count quiet samples, sleep
+    void CheckSilence(float peak, int n);
+
+    // Block kernel for one feature mask; unused features compile out
+    template <unsigned F>
+    void RenderBlock(const Params& p, const VoiceMod& m, float* out, int n);
+
+    using Kernel = void (Voice::*)(const Params&, const VoiceMod&, float*, int);
+    static const Kernel kKernels[kNumKernels];
 
     // One-pole smoothed envelope
     float ProcessEnvelope(float attack_s, float decay_s, float sustain, float release_s,
@@ -38,7 +107,8 @@ private:
     float inv_sr_;
 
     // Oscillator state
-    float saw_phase_;      // 0–1 phasor
+    float saw_phase_;      // 0–1 phasor (one saw; idle in unison mode)
+    UnisonStack unison_;   // Params::unison > 1 replaces the saw
     float sub_phase_;      // 0–1 phasor (sine sub, -1 oct)
     float note_freq_;      // Hz, from MIDI note
     int   midi_note_;
@@ -50,7 +120,23 @@ private:
     float    env_value_;          // amp envelope output, 0–1
     EnvStage filt_env_stage_;
     float    filt_env_value_;     // filter envelope output (always sustain=0)
+    bool     fading_;             // Fade(): release at FADE_S or faster until NoteOn
+    int      quiet_samples_;      // released and under SLEEP_THRESHOLD this long
+    int      sleep_hold_samples_;
 
     // Filter
     Korg35LPF filter_;
+
+    // Block-kernel values kept across blocks and recomputed only when their
+    // inputs change, so small blocks don't pay pow/exp/tan every block
+    struct BlockCache {
+        float bend, bend_mult;           // pitch_bend → 2^(bend·range/12)
+        float decay_s, decay_coeff;
+        float release_s, release_coeff;
+        float cutoff_hz;                 // last static cutoff set on filter_
+    };
+    BlockCache cache_;
+    float attack_coeff_;                 // ENV_ATTACK_S at this sample rate
+    float fade_coeff_;                   // FADE_S at this sample rate
+    float key_track_;                    // 2^(KEY_TRACKING·(note − 60)/12)
 };
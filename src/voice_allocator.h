@@ -13,15 +13,24 @@ public:
             slots_[i].age = 0;
         }
         age_counter_ = 0;
+        limit_ = N;
     }
 
-    // Returns voice index (0..N-1) to trigger.
+    // Allocate from slots 0..n-1 only (1 ≤ n ≤ N). Notes already in higher
+    // slots stay until Release or NoteOff.
+    void SetLimit(int n) { limit_ = n < 1 ? 1 : n > N ? N : n; }
+    int Limit() const { return limit_; }
+
+    // Free slot i whatever it holds (the caller silences the voice)
+    void Release(int i) { slots_[i].midi_note = -1; }
+
+    // Returns voice index (0..limit-1) to trigger.
     // Priority: (1) retrigger same note, (2) free slot, (3) steal oldest.
     int NoteOn(int midi_note) {
         age_counter_++;
 
         // Retrigger if this note is already playing
-        for (int i = 0; i < N; i++) {
+        for (int i = 0; i < limit_; i++) {
             if (slots_[i].midi_note == midi_note) {
                 slots_[i].age = age_counter_;
                 return i;
@@ -29,7 +38,7 @@ public:
         }
 
         // Use a free slot
-        for (int i = 0; i < N; i++) {
+        for (int i = 0; i < limit_; i++) {
             if (slots_[i].midi_note == -1) {
                 slots_[i].midi_note = midi_note;
                 slots_[i].age = age_counter_;
@@ -39,7 +48,7 @@ public:
 
         // All slots busy — steal the oldest
         int oldest = 0;
-        for (int i = 1; i < N; i++) {
+        for (int i = 1; i < limit_; i++) {
             if (slots_[i].age < slots_[oldest].age)
                 oldest = i;
         }
@@ -76,4 +85,5 @@ private:
 
     Slot slots_[N];
     uint32_t age_counter_;
+    int limit_;             // slots NoteOn may use
 };
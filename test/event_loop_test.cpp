@@ -0,0 +1,244 @@
+// test/event_loop_test.cpp — Host test: wake-on-event main loop
+// Build:  make -C host event-loop-test
+// Run:    host/build/event-loop-test
+//
+// Runs EventLoop against a simulated board. The clock is in microseconds
+// and every piece of loop work costs simulated time. Interrupts are
+// scheduled events: MIDI bytes arriving, OLED page DMA finishing (2.9 ms
+// after it starts), the loop timer, and optionally the audio DMA, which
+// interrupts every 1 ms block but posts no flag. Sleep wakes on every
+// interrupt and, like the firmware, goes back to WFI until a flag is
+// pending. Each scenario runs 10 s and checks:
+//   latency — a MIDI message waits at most MAX_MIDI_LATENCY_US from its
+//             interrupt to being serviced, including while the eye is
+//             rendering and pages are in flight
+//   pots    — read every POT_PERIOD_MS, never late by more than a ms
+//   frames  — pages go out 0–7, one at a time, at the eye's frame rate
+//   sleep   — an idle loop is awake for under 2% of the time and only
+//             wakes for its timer and page completions; audio interrupts
+//             end a WFI but never reach the loop
+//   boot    — deferred startup stages all run, one per wake, within
+//             BOOT_DEADLINE_US, with MIDI serviced in between (the
+//             latency check)
+// Exits non-zero on failure.
+
+#include "event_loop.h"
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+static constexpr uint64_t RUN_US             = 10000000;
+static constexpr uint64_t MAX_MIDI_LATENCY_US = 250;
+
+// Loop work, µs of simulated time
+static constexpr uint64_t COST_MIDI   = 20;
+static constexpr uint64_t COST_POTS   = 15;
+static constexpr uint64_t COST_RENDER = 120;   // Advance + Render
+static constexpr uint64_t COST_CHECK  = 30;    // Advance, frame unchanged
+static constexpr uint64_t COST_PAGE   = 100;   // blocking addressing bytes
+static constexpr uint64_t PAGE_DMA_US = 2900;
+static constexpr uint64_t COST_BOOT_STAGE  = 150;    // e.g. 4 OLED init commands
+static constexpr uint64_t BOOT_DEADLINE_US = 10000;
+static constexpr uint64_t AUDIO_BLOCK_US   = 1000;   // 48 frames at 48 kHz
+
+struct SimBoard {
+    // Scenario
+    bool     eye_active = false;     // 33 ms frames that always change
+    uint32_t idle_changes_every = 3; // idle: one frame check in N changes
+    int      boot_stages = 0;        // deferred startup stages to run
+    bool     audio = false;          // audio DMA interrupt every block
+
+    // Simulated hardware
+    EventFlags* flags = nullptr;
+    uint64_t now_us = 0;
+    uint64_t timer_at = UINT64_MAX;
+    uint64_t dma_at = UINT64_MAX;
+    uint64_t audio_at = UINT64_MAX;
+    std::vector<uint64_t> midi_at;   // arrival times, sorted
+    size_t   midi_next = 0;          // next to arrive
+    size_t   midi_serviced = 0;      // arrived ones up to here were serviced
+
+    // Measurements
+    uint64_t busy_us = 0;
+    uint64_t max_latency_us = 0;
+    std::vector<uint64_t> pot_reads;
+    uint32_t frame_checks = 0, frames = 0, pages = 0;
+    int      next_page = 0;
+    bool     page_errors = false;
+    int      boot_done = 0;
+    uint64_t boot_end_us = 0;
+    uint32_t audio_irqs = 0, flagless_wakes = 0;
+
+    // Deliver every interrupt due by t, then move the clock there
+    void AdvanceTo(uint64_t t) {
+        for (;;) {
+            uint64_t midi = midi_next < midi_at.size() ? midi_at[midi_next] : UINT64_MAX;
+            uint64_t first = std::min({midi, timer_at, dma_at, audio_at});
+            if (first > t) break;
+            if (first == midi) {
+                midi_next++;
+                flags->Post(EVENT_MIDI);
+            } else if (first == timer_at) {
+                timer_at = UINT64_MAX;
+                flags->Post(EVENT_TIMER);
+            } else if (first == dma_at) {
+                dma_at = UINT64_MAX;
+                flags->Post(EVENT_PAGE_DONE);
+            } else {
+                audio_at += AUDIO_BLOCK_US;   // renders a block, posts nothing
+                audio_irqs++;
+            }
+        }
+        now_us = t;
+    }
+
+    void Spend(uint64_t us) {
+        busy_us += us;
+        AdvanceTo(now_us + us);
+    }
+
+    uint32_t NowMs() { return static_cast<uint32_t>(now_us / 1000); }
+
+    // One WFI per pass: it ends at the next interrupt, whichever it is
+    void Sleep(const EventFlags& f) {
+        while (!f.Pending()) {
+            uint64_t midi = midi_next < midi_at.size() ? midi_at[midi_next] : UINT64_MAX;
+            uint64_t next = std::min({midi, timer_at, dma_at, audio_at});
+            if (next == UINT64_MAX) return;   // nothing will ever wake us
+            AdvanceTo(next);
+            if (!f.Pending()) flagless_wakes++;
+        }
+    }
+
+    // The timer counts whole ms from now, like TIM5 restarted at 0
+    void ArmTimer(uint32_t ms) { timer_at = now_us + ms * 1000ull; }
+
+    void ServiceMidi() {
+        for (; midi_serviced < midi_next; midi_serviced++)
+            max_latency_us = std::max(max_latency_us, now_us - midi_at[midi_serviced]);
+        Spend(COST_MIDI);
+    }
+
+    void ReadPots(float) {
+        pot_reads.push_back(now_us);
+        Spend(COST_POTS);
+    }
+
+    uint32_t FramePeriodMs() { return eye_active ? 33 : 100; }
+
+    bool PrepareFrame(float) {
+        bool changed = eye_active || ++frame_checks % idle_changes_every == 0;
+        Spend(changed ? COST_RENDER : COST_CHECK);
+        if (changed) frames++;
+        return changed;
+    }
+
+    bool ServiceStorage() { return false; }
+
+    bool ServiceBoot() {
+        if (boot_done == boot_stages) return false;
+        Spend(COST_BOOT_STAGE);
+        boot_end_us = now_us;
+        return ++boot_done < boot_stages;
+    }
+
+    void StartPage(int page) {
+        if (page != next_page || dma_at != UINT64_MAX) page_errors = true;
+        next_page = (page + 1) % EventLoop<SimBoard>::NUM_PAGES;
+        pages++;
+        Spend(COST_PAGE);
+        dma_at = now_us + PAGE_DMA_US;
+    }
+};
+
+static int Check(bool ok, const char* what) {
+    std::printf("  %-58s %s\n", what, ok ? "ok" : "FAIL");
+    return ok ? 0 : 1;
+}
+
+// midi_mean_us: mean gap between MIDI messages (Poisson), 0 = none
+static int Scenario(const char* name, bool eye_active, double midi_mean_us, bool expect_idle,
+                    int boot_stages = 0, bool audio = false) {
+    EventFlags flags;
+    SimBoard board;
+    board.flags = &flags;
+    board.eye_active = eye_active;
+    board.boot_stages = boot_stages;
+    board.audio = audio;
+    if (audio) board.audio_at = AUDIO_BLOCK_US;
+    if (midi_mean_us > 0) {
+        std::mt19937 rng(1234);
+        std::exponential_distribution<double> gap(1.0 / midi_mean_us);
+        for (double t = gap(rng); t < RUN_US; t += gap(rng))
+            board.midi_at.push_back(static_cast<uint64_t>(t));
+    }
+
+    EventLoop<SimBoard> loop;
+    loop.Init(board, flags);
+    while (board.now_us < RUN_US) {
+        uint64_t before = board.now_us;
+        loop.RunOnce();
+        if (board.now_us == before && !flags.Pending() && board.timer_at == UINT64_MAX) break;
+    }
+
+    double seconds = RUN_US / 1e6;
+    uint64_t worst_gap = 0, shortest_gap = UINT64_MAX;
+    for (size_t i = 1; i < board.pot_reads.size(); i++) {
+        uint64_t g = board.pot_reads[i] - board.pot_reads[i - 1];
+        worst_gap = std::max(worst_gap, g);
+        shortest_gap = std::min(shortest_gap, g);
+    }
+    double fps = board.frames / seconds;
+    double awake = 100.0 * board.busy_us / board.now_us;
+
+    std::printf("%s: %zu MIDI, max latency %llu us, %.1f fps, %.0f wakes/s, awake %.2f%%\n",
+                name, board.midi_at.size(), (unsigned long long)board.max_latency_us, fps,
+                loop.Wakes() / seconds, awake);
+    int failures = 0;
+    char what[96];
+    std::snprintf(what, sizeof(what), "latency: MIDI serviced within %llu us",
+                  (unsigned long long)MAX_MIDI_LATENCY_US);
+    failures += Check(board.midi_serviced == board.midi_at.size() &&
+                      board.max_latency_us <= MAX_MIDI_LATENCY_US, what);
+    failures += Check(shortest_gap >= 49000 && worst_gap <= 51000,
+                      "pots: every 50 ms, within a ms");
+    // the last frame may still be going out when the run ends
+    uint32_t sent = board.pages + (loop.Sending() ? 8 - board.next_page : 0);
+    failures += Check(!board.page_errors && sent == 8 * board.frames,
+                      "frames: pages in order, one in flight at a time");
+    if (eye_active)
+        failures += Check(fps > 28.0 && fps <= 30.5, "frames: ~30 fps while the eye moves");
+    else
+        failures += Check(fps > 3.0 && fps < 3.6, "frames: idle checks at 10 Hz, 1 in 3 sent");
+    if (boot_stages) {
+        std::snprintf(what, sizeof(what), "boot: %d deferred stages done within %llu ms",
+                      boot_stages, (unsigned long long)(BOOT_DEADLINE_US / 1000));
+        failures += Check(board.boot_done == boot_stages && board.boot_end_us <= BOOT_DEADLINE_US,
+                          what);
+    }
+    if (expect_idle) {
+        // pot reads + frame checks + 8 page completions per frame sent
+        double expected = 1000.0 / EventLoop<SimBoard>::POT_PERIOD_MS + 10.0 + 8.0 * fps;
+        failures += Check(awake < 2.0 && loop.Wakes() / seconds <= expected + 1.0,
+                          "sleep: idle loop awake < 2%, wakes only on its events");
+        if (audio)
+            // all but the ones landing while the loop is busy end a WFI
+            failures += Check(board.audio_irqs >= RUN_US / AUDIO_BLOCK_US - 1 &&
+                              board.flagless_wakes >= board.audio_irqs * 9 / 10,
+                              "sleep: back to WFI after each flagless audio interrupt");
+    }
+    return failures;
+}
+
+int main() {
+    int failures = 0;
+    failures += Scenario("idle", false, 0, true);
+    failures += Scenario("idle, MIDI every 5 ms", false, 5000, false);
+    failures += Scenario("playing, MIDI every 5 ms", true, 5000, false);
+    failures += Scenario("playing, MIDI every 0.4 ms", true, 400, false);
+    failures += Scenario("booting, MIDI every 0.4 ms", true, 400, false, 12);
+    failures += Scenario("idle, audio running", false, 0, true, 0, true);
+    std::printf("%s\n", failures ? "FAILED" : "PASSED");
+    return failures ? 1 : 0;
+}
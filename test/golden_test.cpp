@@ -0,0 +1,340 @@
+// test/golden_test.cpp — Host test: renders vs stored reference WAVs
+// Build:  make -C host golden-test
+// Run:    host/build/golden-test [options]      (from host/, as `make test` does)
+//
+//   --update       re-render every scenario into the reference directory
+//   --refs DIR     reference directory (default ../test/golden)
+//   --max-abs X    override every scenario's max |sample error|
+//   --spec-db X    override every scenario's max 1/3-octave band difference
+//   --only NAME    run one scenario
+//
+// Each scenario is a fixed MIDI stream played through SynthEngine exactly the
+// way ms20-render does. A render passes if it matches its reference within
+// both tolerances:
+//   max abs  — largest per-sample difference (0 = bit-exact)
+//   spec dB  — largest level difference in any 1/3-octave band (40 Hz–20 kHz)
+//              of the Hann-windowed average spectrum, over bands within 60 dB
+//              of the loudest one
+// Failures print where the error peaks and write <name>.diff.wav (render −
+// reference) next to the build output for listening.
+//
+// After a change that is *meant* to alter the sound, listen, then
+// `make -C host golden-update` and commit the new references.
+
+#include "offline_render.h"
+#include "wav_file.h"
+#include "fft.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+static constexpr float SR = 48000.0f;
+
+// --- Scenario definitions ---
+
+struct Scenario {
+    const char* name;
+    const char* what;
+    double      length_s;   // render length; all messages fall inside it
+    float       max_abs;    // per-scenario tolerance
+    float       spec_db;
+    std::function<void(std::vector<MidiMessage>&)> build;
+};
+
+static constexpr uint8_t NOTE_ON  = 0x90 | MIDI_CHANNEL;
+static constexpr uint8_t NOTE_OFF = 0x80 | MIDI_CHANNEL;
+static constexpr uint8_t CC       = 0xB0 | MIDI_CHANNEL;
+static constexpr uint8_t BEND     = 0xE0 | MIDI_CHANNEL;
+
+static void Note(std::vector<MidiMessage>& m, double t, double len, int note, int vel = 100) {
+    m.push_back({t, NOTE_ON, (uint8_t)note, (uint8_t)vel});
+    m.push_back({t + len, NOTE_OFF, (uint8_t)note, 0});
+}
+
+static void Ramp(std::vector<MidiMessage>& m, double t0, double t1, int cc, int v0, int v1) {
+    int steps = std::abs(v1 - v0);
+    for (int s = 0; s <= steps; s++) {
+        double frac = steps ? (double)s / steps : 1.0;
+        m.push_back({t0 + frac * (t1 - t0), CC, (uint8_t)cc,
+                     (uint8_t)(v0 + (v1 > v0 ? s : -s))});
+    }
+}
+
+static const std::vector<Scenario>& Scenarios() {
+    static const std::vector<Scenario> list = {
+        {"notes", "single notes across the keyboard, soft to hard", 1.2, 1e-4f, 0.25f,
+         [](std::vector<MidiMessage>& m) {
+             const int notes[] = {28, 40, 52, 64, 76, 88, 100};
+             for (int i = 0; i < 7; i++) Note(m, i * 0.15, 0.12, notes[i], 20 + i * 17);
+         }},
+        {"chords_steal", "6-note chords on 4 voices (oldest-voice stealing)", 1.2, 1e-4f, 0.25f,
+         [](std::vector<MidiMessage>& m) {
+             const int chord[] = {48, 52, 55, 59, 62, 65};
+             for (int i = 0; i < 6; i++) Note(m, i * 0.05, 0.5, chord[i]);
+             for (int i = 0; i < 6; i++) Note(m, 0.6 + i * 0.03, 0.4, chord[i] + 5, 70);
+         }},
+        {"cutoff_sweep", "held chord, cutoff sweep at high resonance", 1.5, 1e-4f, 0.25f,
+         [](std::vector<MidiMessage>& m) {
+             m.push_back({0.0, CC, CC_RES, 110});
+             Note(m, 0.0, 1.4, 36);
+             Note(m, 0.0, 1.4, 43);
+             Ramp(m, 0.0, 0.7, CC_CUTOFF, 0, 127);
+             Ramp(m, 0.7, 1.4, CC_CUTOFF, 127, 10);
+         }},
+        {"filter_nr", "Newton-Raphson filter at full resonance, cutoff sweep", 1.5, 1e-4f, 0.25f,
+         [](std::vector<MidiMessage>& m) {
+             m.push_back({0.0, CC, CC_FILTER_NR, 127});
+             m.push_back({0.0, CC, CC_RES, 127});
+             m.push_back({0.0, CC, CC_DECAY, 127});
+             Note(m, 0.0, 1.4, 33);
+             Note(m, 0.5, 0.8, 52);
+             Ramp(m, 0.0, 0.7, CC_CUTOFF, 20, 127);
+             Ramp(m, 0.7, 1.4, CC_CUTOFF, 127, 30);
+         }},
+        {"fold_sub_drive", "wavefolder, sub and overdrive sweeps", 1.5, 1e-4f, 0.25f,
+         [](std::vector<MidiMessage>& m) {
+             m.push_back({0.0, CC, CC_DECAY, 127});
+             Note(m, 0.0, 1.4, 45);
+             Ramp(m, 0.0, 0.5, CC_FOLD, 0, 127);
+             Ramp(m, 0.3, 0.9, CC_SUB, 0, 127);
+             Ramp(m, 0.8, 1.4, CC_FX, 0, 127);
+         }},
+        // FFT partitions round differently under FMA contraction; after 30x
+        // drive that is ~2e-3 on a 2.3 peak
+        {"drive_cab_ir", "overdrive with the IR cabinet switched in and out", 1.5, 1e-2f, 0.25f,
+         [](std::vector<MidiMessage>& m) {
+             m.push_back({0.0, CC, CC_DECAY, 127});
+             m.push_back({0.0, CC, CC_FX, 90});
+             Note(m, 0.0, 1.4, 40);
+             m.push_back({0.4, CC, CC_CAB, 127});
+             Note(m, 0.6, 0.5, 52);
+             m.push_back({1.0, CC, CC_CAB, 0});
+             m.push_back({1.2, CC, CC_CAB, 127});
+         }},
+        // Bend maths goes through powf, so a different compiler/FMA contraction
+        // shifts the oscillator phase by a few ulps per sample and the saw
+        // edges drift apart: judged on the spectrum only.
+        {"pitch_bend", "held note with bend wiggles and a CC envelope change", 1.2, 4.0f, 0.25f,
+         [](std::vector<MidiMessage>& m) {
+             m.push_back({0.0, CC, CC_DECAY, 127});
+             m.push_back({0.0, CC, CC_FILT_ENV, 100});
+             Note(m, 0.0, 1.1, 57);
+             for (int i = 0; i <= 200; i++) {
+                 double t = 0.05 + i * 0.005;
+                 int v = 8192 + (int)(6000.0 * std::sin(i * 0.12));
+                 m.push_back({t, BEND, (uint8_t)(v & 0x7F), (uint8_t)(v >> 7)});
+             }
+         }},
+        {"envelopes", "decay / amp env / filter env settings", 1.5, 1e-4f, 0.25f,
+         [](std::vector<MidiMessage>& m) {
+             const int dec[] = {0, 64, 127}, amp[] = {127, 20, 90}, fe[] = {0, 127, 60};
+             for (int i = 0; i < 3; i++) {
+                 double t = i * 0.5;
+                 m.push_back({t, CC, CC_DECAY, (uint8_t)dec[i]});
+                 m.push_back({t, CC, CC_AMP_ENV, (uint8_t)amp[i]});
+                 m.push_back({t, CC, CC_FILT_ENV, (uint8_t)fe[i]});
+                 Note(m, t + 0.01, 0.3, 50 + i * 7);
+             }
+         }},
+        {"fx_space", "staccato notes through the chorus → reverb crossfade", 1.5, 1e-4f, 0.25f,
+         [](std::vector<MidiMessage>& m) {
+             for (int i = 0; i < 8; i++) Note(m, i * 0.12, 0.05, 60 + (i % 4) * 3);
+             Ramp(m, 0.0, 1.0, CC_FX_MIX, 0, 127);
+         }},
+        // Pitch routes ramp the phase increment: same drift as pitch_bend
+        {"mod_routes", "LFO vibrato + wah, S&H fold, mod env pitch blip", 1.5, 4.0f, 0.25f,
+         [](std::vector<MidiMessage>& m) {
+             m.push_back({0.0, CC, CC_DECAY, 110});
+             m.push_back({0.0, CC, CC_AMP_ENV, 40});
+             m.push_back({0.0, CC, CC_FOLD, 30});
+             m.push_back({0.0, CC, CC_LFO1_RATE, 90});
+             m.push_back({0.0, CC, CC_LFO2_RATE, 100});
+             m.push_back({0.0, CC, CC_MOD_ENV_DECAY, 40});
+             m.push_back({0.0, CC, CC_MOD_LFO1_PITCH, 80});
+             m.push_back({0.0, CC, CC_MOD_LFO2_FOLD, 110});
+             m.push_back({0.0, CC, CC_MOD_ENV_PITCH, 90});
+             Note(m, 0.01, 0.6, 48);
+             m.push_back({0.7, CC, CC_FILT_ENV, 100});
+             m.push_back({0.7, CC, CC_MOD_LFO1_CUTOFF, 20});
+             m.push_back({0.7, CC, CC_MOD_ENV_CUTOFF, 100});
+             Note(m, 0.72, 0.7, 55);
+             m.push_back({1.25, CC, CC_MOD_LFO1_PITCH, 64});   // routes off mid-note
+             m.push_back({1.25, CC, CC_MOD_LFO1_CUTOFF, 64});
+         }},
+        // Lane ratios go through exp2f: a different libm moves them by an
+        // ulp and the stacked saws' edges drift apart, as in pitch_bend
+        {"unison", "unison count and detune sweeps over a held chord", 1.5, 4.0f, 0.25f,
+         [](std::vector<MidiMessage>& m) {
+             m.push_back({0.0, CC, CC_DECAY, 127});
+             m.push_back({0.0, CC, CC_UNISON, 127});
+             Note(m, 0.0, 1.4, 45);
+             Note(m, 0.0, 1.4, 52);
+             Ramp(m, 0.1, 0.7, CC_DETUNE, 0, 127);
+             m.push_back({0.8, CC, CC_UNISON, 40});
+             m.push_back({1.1, CC, CC_UNISON, 0});   // back to the plain saw mid-note
+         }},
+    };
+    return list;
+}
+
+static std::vector<float> Render(const Scenario& sc) {
+    std::vector<MidiMessage> msgs;
+    sc.build(msgs);
+    SortMessages(msgs);
+
+    OfflineSynth synth;
+    synth.Init(SR);
+    RenderOptions opt;
+    opt.sample_rate = SR;
+    // Render the whole length: releases and FX tails after the last
+    // message are part of the reference
+    double last_s = msgs.empty() ? 0.0 : msgs.back().time_s;
+    opt.tail_s = std::max(0.0, sc.length_s - last_s);
+    std::vector<float> out = RenderOffline(synth.engine, msgs, opt);
+    out.resize(static_cast<size_t>(sc.length_s * SR), 0.0f);
+    return out;
+}
+
+// --- Spectral comparison ---
+
+static constexpr int SPEC_N = 1024;
+
+// Hann-windowed power spectrum averaged over 50%-overlapping frames
+static std::vector<double> AverageSpectrum(const std::vector<float>& x) {
+    static const Fft<SPEC_N> fft;
+
+    std::vector<double> power(SPEC_N / 2, 0.0);
+    float re[SPEC_N], im[SPEC_N];
+    for (size_t start = 0; start + SPEC_N <= x.size(); start += SPEC_N / 2) {
+        for (int i = 0; i < SPEC_N; i++) {
+            float w = 0.5f - 0.5f * std::cos(6.28318530718f * i / SPEC_N);
+            re[i] = x[start + i] * w;
+            im[i] = 0.0f;
+        }
+        fft.Forward(re, im);
+        for (int k = 0; k < SPEC_N / 2; k++) power[k] += (double)re[k] * re[k] + (double)im[k] * im[k];
+    }
+    return power;
+}
+
+struct BandDiff {
+    double max_db = 0.0;
+    double at_hz  = 0.0;
+};
+
+static BandDiff CompareBands(const std::vector<float>& ref, const std::vector<float>& out) {
+    std::vector<double> pr = AverageSpectrum(ref), po = AverageSpectrum(out);
+    double bin_hz = SR / SPEC_N;
+
+    std::vector<double> er, eo, centre;
+    for (double fc = 40.0; fc < 20000.0; fc *= std::pow(2.0, 1.0 / 3.0)) {
+        int k0 = (int)(fc * std::pow(2.0, -1.0 / 6.0) / bin_hz);
+        int k1 = (int)(fc * std::pow(2.0, 1.0 / 6.0) / bin_hz);
+        if (k1 <= k0) k1 = k0 + 1;
+        double a = 1e-30, b = 1e-30;
+        for (int k = k0; k < k1 && k < SPEC_N / 2; k++) { a += pr[k]; b += po[k]; }
+        er.push_back(a);
+        eo.push_back(b);
+        centre.push_back(fc);
+    }
+
+    double peak = 0.0;
+    for (double e : er) peak = std::fmax(peak, e);
+    BandDiff d;
+    for (size_t i = 0; i < er.size(); i++) {
+        if (er[i] < peak * 1e-6) continue;  // more than 60 dB down
+        double db = std::fabs(10.0 * std::log10(eo[i] / er[i]));
+        if (db > d.max_db) { d.max_db = db; d.at_hz = centre[i]; }
+    }
+    return d;
+}
+
+// --- Driver ---
+
+int main(int argc, char** argv) {
+    std::string refs = "../test/golden";
+    bool update = false;
+    float max_abs_override = -1.0f, spec_db_override = -1.0f;
+    const char* only = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        bool has_val = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--update"))                  update = true;
+        else if (!std::strcmp(argv[i], "--refs") && has_val)    refs = argv[++i];
+        else if (!std::strcmp(argv[i], "--max-abs") && has_val) max_abs_override = std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "--spec-db") && has_val) spec_db_override = std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "--only") && has_val)    only = argv[++i];
+        else {
+            std::fprintf(stderr, "usage: golden-test [--update] [--refs dir] [--max-abs x]"
+                                 " [--spec-db x] [--only name]\n");
+            return 2;
+        }
+    }
+
+    int failed = 0;
+    if (!update)
+        std::printf("%-16s %12s %10s %9s %10s\n", "scenario", "max abs", "at s", "rms", "band dB");
+    for (const Scenario& sc : Scenarios()) {
+        if (only && std::strcmp(only, sc.name)) continue;
+        std::vector<float> out = Render(sc);
+        std::string ref_path = refs + "/" + sc.name + ".wav";
+
+        if (update) {
+            if (!WriteWav(ref_path, out, (int)SR)) {
+                std::printf("%-16s cannot write %s\n", sc.name, ref_path.c_str());
+                return 1;
+            }
+            std::printf("%-16s updated (%s)\n", sc.name, sc.what);
+            continue;
+        }
+
+        std::vector<float> ref;
+        int ref_sr = 0;
+        if (!ReadWav(ref_path, ref, ref_sr) || ref_sr != (int)SR || ref.size() != out.size()) {
+            std::printf("%-16s missing or mismatched reference %s\n", sc.name, ref_path.c_str());
+            failed++;
+            continue;
+        }
+
+        double max_abs = 0.0, sum_sq = 0.0;
+        size_t at = 0;
+        std::vector<float> diff(out.size());
+        for (size_t i = 0; i < out.size(); i++) {
+            diff[i] = out[i] - ref[i];
+            double e = std::fabs((double)diff[i]);
+            sum_sq += e * e;
+            if (e > max_abs) { max_abs = e; at = i; }
+        }
+        double rms = std::sqrt(sum_sq / out.size());
+        BandDiff bd = CompareBands(ref, out);
+
+        float tol_abs = max_abs_override >= 0.0f ? max_abs_override : sc.max_abs;
+        float tol_db  = spec_db_override >= 0.0f ? spec_db_override : sc.spec_db;
+        bool ok = max_abs <= tol_abs && bd.max_db <= tol_db;
+
+        std::printf("%-16s %12.3g %10.4f %9.2g %10.3f  %s\n",
+                    sc.name, max_abs, at / SR, rms, bd.max_db, ok ? "ok" : "FAIL");
+        if (!ok) {
+            failed++;
+            std::printf("    %s\n", sc.what);
+            if (max_abs > tol_abs)
+                std::printf("    max abs %.3g > %.3g at sample %zu (%.4f s): got %.6f, want %.6f\n",
+                            max_abs, tol_abs, at, at / SR, out[at], ref[at]);
+            if (bd.max_db > tol_db)
+                std::printf("    band %.0f Hz differs by %.2f dB (> %.2f)\n",
+                            bd.at_hz, bd.max_db, tol_db);
+            std::string diff_path = std::string("build/") + sc.name + ".diff.wav";
+            if (WriteWav(diff_path, diff, (int)SR))
+                std::printf("    difference written to %s\n", diff_path.c_str());
+        }
+    }
+
+    if (update) return 0;
+    std::printf(failed ? "FAILED (%d scenario%s)\n" : "PASSED\n", failed, failed == 1 ? "" : "s");
+    return failed ? 1 : 0;
+}
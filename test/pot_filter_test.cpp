@@ -0,0 +1,188 @@
+// test/pot_filter_test.cpp — Host test: legacy IIR+dead-zone vs 1-Euro pots
+// Build:  make -C host pot-filter-test
+// Run:    host/build/pot-filter-test
+//
+// Drives both smoothers with synthetic noisy ADC traces (Gaussian wiper
+// noise plus occasional I2C impulse spikes, sampled at the 20 fps main-loop
+// rate) and reports, per trace:
+//   settle  — ms from the end of a move until the output stays within one
+//             0–127 CC step of the final position
+//   jitter  — output updates and peak-to-peak wander while the pot rests
+//   step    — largest single output jump during a slow, fine move
+// Exits non-zero if the new filter is worse than the legacy one.
+
+#include "pot_filter.h"
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+static constexpr float FRAME_S   = 0.05f;         // main loop pot rate (20 fps)
+static constexpr float CC_STEP   = 1.0f / 127.0f;
+static constexpr float ADC_NOISE = 0.0025f;       // 1σ, ~2.5 LSB of 0-1000
+
+// --- Legacy smoother (adc_pots.h before the 1-Euro rewrite) ---
+
+struct LegacyPot {
+    static constexpr float DEAD_ZONE = 0.02f;
+    static constexpr float ALPHA     = 0.3f;
+
+    bool Process(float raw) {
+        if (!init) {
+            hist[0] = hist[1] = hist[2] = smoothed = sent = raw;
+            init = true;
+            return true;
+        }
+        hist[idx] = raw;
+        idx = (idx + 1) % 3;
+        float med = Median3(hist[0], hist[1], hist[2]);
+        smoothed += ALPHA * (med - smoothed);
+        if (std::fabs(smoothed - sent) > DEAD_ZONE) {
+            sent = smoothed;
+            return true;
+        }
+        return false;
+    }
+    float Value() const { return sent; }
+
+    float hist[3] = {};
+    int   idx = 0;
+    float smoothed = 0.0f, sent = 0.0f;
+    bool  init = false;
+};
+
+struct NewPot {
+    bool Process(float raw) { return f.Process(raw, FRAME_S, cfg); }
+    float Value() const { return f.Value(cfg); }
+    PotFilter f;
+    PotFilterConfig cfg;
+};
+
+// --- Deterministic noise ---
+
+struct Rng {
+    uint32_t s;
+    float Uniform() {
+        s = s * 1664525u + 1013904223u;
+        return (float)(s >> 8) * (1.0f / 16777216.0f);
+    }
+    float Gauss() {
+        float u1 = Uniform() + 1e-7f, u2 = Uniform();
+        return std::sqrt(-2.0f * std::log(u1)) * std::cos(6.2831853f * u2);
+    }
+};
+
+// Ideal pot position over time, plus the frame where motion ends
+struct Trace {
+    const char* name;
+    std::vector<float> ideal;
+    int move_end;  // first frame the pot is at rest at its final position
+    bool fine;     // slow move: judge the largest output jump
+};
+
+static std::vector<float> Noisy(const std::vector<float>& ideal, uint32_t seed) {
+    Rng rng{seed};
+    std::vector<float> out(ideal.size());
+    for (size_t i = 0; i < ideal.size(); i++) {
+        float x = ideal[i] + ADC_NOISE * rng.Gauss();
+        if (rng.Uniform() < 0.01f) x += (rng.Uniform() - 0.5f) * 0.3f;  // I2C spike
+        out[i] = std::fmin(1.0f, std::fmax(0.0f, x));
+    }
+    return out;
+}
+
+static Trace Ramp(const char* name, float from, float to, float move_s, float rest_s,
+                  bool fine = false) {
+    Trace t{name, {}, 0, fine};
+    int pre  = (int)(1.0f / FRAME_S);
+    int move = (int)(move_s / FRAME_S);
+    int rest = (int)(rest_s / FRAME_S);
+    for (int i = 0; i < pre; i++) t.ideal.push_back(from);
+    for (int i = 0; i < move; i++) t.ideal.push_back(from + (to - from) * (i + 1) / move);
+    t.move_end = (int)t.ideal.size();
+    for (int i = 0; i < rest; i++) t.ideal.push_back(to);
+    return t;
+}
+
+struct Result {
+    float settle_ms;
+    int   rest_updates;
+    float rest_p2p;
+    float max_step;
+};
+
+template <typename Pot>
+static Result Run(const Trace& t, const std::vector<float>& raw) {
+    Pot pot;
+    std::vector<float> out(raw.size());
+    for (size_t i = 0; i < raw.size(); i++) {
+        pot.Process(raw[i]);
+        out[i] = pot.Value();
+    }
+
+    Result r{};
+    float final_pos = t.ideal.back();
+
+    // Settle: last frame after move_end that was outside ±1 CC step
+    int last_bad = t.move_end - 1;
+    for (size_t i = t.move_end; i < out.size(); i++)
+        if (std::fabs(out[i] - final_pos) > CC_STEP) last_bad = (int)i;
+    r.settle_ms = (last_bad - t.move_end + 1) * FRAME_S * 1000.0f;
+    if (last_bad == (int)out.size() - 1) r.settle_ms = INFINITY;
+
+    // Rest jitter: measured over the second half of the rest period
+    size_t rest_from = t.move_end + (out.size() - t.move_end) / 2;
+    float lo = out[rest_from], hi = out[rest_from];
+    for (size_t i = rest_from + 1; i < out.size(); i++) {
+        if (out[i] != out[i - 1]) r.rest_updates++;
+        lo = std::fmin(lo, out[i]);
+        hi = std::fmax(hi, out[i]);
+    }
+    r.rest_p2p = hi - lo;
+
+    for (int i = 1; i < t.move_end; i++)
+        r.max_step = std::fmax(r.max_step, std::fabs(out[i] - out[i - 1]));
+    return r;
+}
+
+static void Print(const char* who, const Result& r) {
+    std::printf("  %-7s settle %7.0f ms   rest updates %3d   rest p2p %6.4f   max step %6.4f\n",
+                who, r.settle_ms, r.rest_updates, r.rest_p2p, r.max_step);
+}
+
+int main() {
+    const Trace traces[] = {
+        Ramp("rest",            0.50f, 0.50f, 0.05f, 10.0f),
+        Ramp("fast sweep",      0.10f, 0.90f, 0.25f,  4.0f),
+        Ramp("medium sweep",    0.80f, 0.30f, 1.00f,  4.0f),
+        Ramp("slow fine move",  0.40f, 0.45f, 5.00f,  4.0f, true),
+        Ramp("to bottom rail",  0.30f, 0.00f, 0.50f,  4.0f),
+        Ramp("to top rail",     0.70f, 1.00f, 0.50f,  4.0f),
+    };
+
+    int failures = 0;
+    uint32_t seed = 12345;
+    for (const Trace& t : traces) {
+        std::vector<float> raw = Noisy(t.ideal, seed++);
+        Result old_r = Run<LegacyPot>(t, raw);
+        Result new_r = Run<NewPot>(t, raw);
+        std::printf("%s\n", t.name);
+        Print("legacy", old_r);
+        Print("1-euro", new_r);
+
+        // The new filter must reach ±1 CC step (legacy often never does),
+        // must not chatter at rest, and must not quantize slow moves.
+        bool ok = std::isfinite(new_r.settle_ms)
+               && new_r.settle_ms <= old_r.settle_ms
+               && new_r.rest_p2p <= CC_STEP
+               && new_r.rest_updates <= 2
+               && (!t.fine || new_r.max_step < old_r.max_step);
+        if (!ok) {
+            std::printf("  FAIL\n");
+            failures++;
+        }
+    }
+
+    std::printf("%s\n", failures ? "FAILED" : "PASSED");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,189 @@
+// test/quality_governor_test.cpp — Host test: CPU-load quality governor
+// Build:  make -C host quality-governor-test
+// Run:    host/build/quality-governor-test
+//
+// Control loop: drives a QualityGovernor with a synthetic cost model
+// (callback load = demand × the cost share each level keeps) and checks
+//   light     — a patch well under budget never leaves full quality
+//   overload  — 1.3× the budget settles at the first level under
+//               STEP_DOWN_LOAD within a few hundred ms, and the blocks
+//               over budget stop
+//   recover   — when the demand falls, every level comes back, one per
+//               RESTORE_S, none early
+//   threshold — a patch that is calm one level down but overloads every
+//               time full quality returns doesn't hunt: the restore time
+//               backs off and the step count stays small
+//
+// Clicks: renders a held chord through SynthEngine (drive, IR cabinet,
+// full reverb) and walks the quality level 0 → 4 → 0 mid-note. Right after
+// every transition the largest second difference of the output must stay
+// within CLICK_RATIO of the steady-state maximum on either side of it (the
+// levels sound different: at QUALITY_LEAN_FX the chorus's dry half lets
+// sharper edges through than the reverb does). A hard 25% gain step in
+// the same signal is checked to fail that test. Exits non-zero on failure.
+
+#include "quality_governor.h"
+#include "synth_engine.h"
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+static constexpr float SR     = 48000.0f;
+static constexpr int   BLOCK  = 48;
+static constexpr float BLOCKS_PER_S = SR / BLOCK;
+static constexpr uint32_t BUDGET = 480000;
+
+// Share of the full-quality cost each level keeps
+static constexpr float LEVEL_COST[QUALITY_NUM_LEVELS] = {1.0f, 0.8f, 0.6f, 0.45f, 0.3f};
+
+struct Trace {
+    int   max_level = 0;
+    int   final_level = 0;
+    int   over_budget = 0;      // blocks with load > 1
+    int   last_over = -1;       // last such block
+    std::vector<int> level;     // per block
+};
+
+// load(b, q): load of block b rendered at level q
+template <typename Load>
+static Trace Drive(QualityGovernor& gov, int blocks, Load load_at) {
+    Trace t;
+    for (int b = 0; b < blocks; b++) {
+        int q = gov.Level();
+        float load = load_at(b, q);
+        if (load > 1.0f) {
+            t.over_budget++;
+            t.last_over = b;
+        }
+        gov.Update(static_cast<uint32_t>(load * BUDGET), BUDGET);
+        t.level.push_back(q);
+        if (q > t.max_level) t.max_level = q;
+    }
+    t.final_level = gov.Level();
+    return t;
+}
+
+static int Check(bool ok, const char* what) {
+    std::printf("  %-58s %s\n", what, ok ? "ok" : "FAIL");
+    return ok ? 0 : 1;
+}
+
+static int ControlLoop() {
+    int failures = 0;
+    QualityGovernor gov;
+    int second = static_cast<int>(BLOCKS_PER_S);
+
+    std::printf("control loop\n");
+    gov.Init(BLOCKS_PER_S);
+    Trace light = Drive(gov, 10 * second, [](int, int q) { return 0.6f * LEVEL_COST[q]; });
+    failures += Check(light.max_level == 0 && gov.Steps() == 0, "light: 60% load stays at full quality");
+
+    gov.Init(BLOCKS_PER_S);
+    Trace over = Drive(gov, 5 * second, [](int, int q) { return 1.3f * LEVEL_COST[q]; });
+    // 1.3 × {1, .8, .6} = 1.3, 1.04, 0.78: the first level under 0.8 is LEAN_FX
+    failures += Check(over.final_level == QUALITY_LEAN_FX && over.max_level == QUALITY_LEAN_FX,
+                      "overload: 130% settles at QUALITY_LEAN_FX");
+    failures += Check(over.last_over >= 0 && over.last_over < second / 2,
+                      "overload: blocks over budget stop within 500 ms");
+
+    // Demand falls to 30%: one level back per RESTORE_S (plus the settle hold)
+    int restore = static_cast<int>(QualityGovernor::RESTORE_S * BLOCKS_PER_S);
+    Trace rec = Drive(gov, 10 * second, [](int, int q) { return 0.3f * LEVEL_COST[q]; });
+    int first_up = -1;
+    for (size_t b = 0; b < rec.level.size(); b++)
+        if (rec.level[b] < QUALITY_LEAN_FX) { first_up = static_cast<int>(b); break; }
+    failures += Check(rec.final_level == QUALITY_FULL, "recover: back to full quality");
+    failures += Check(first_up >= restore, "recover: no level returns before RESTORE_S");
+
+    // Full quality at 90%, everything below at 45%: each restore overloads.
+    // At a fixed RESTORE_S that is a round trip every ~2 s (~58 steps a
+    // minute); backing off 2, 4, 8, 16, 32 s leaves a handful.
+    gov.Init(BLOCKS_PER_S);
+    Drive(gov, 60 * second, [](int, int q) { return q ? 0.45f : 0.9f; });
+    std::printf("  threshold: %u steps in 60 s\n", gov.Steps());
+    failures += Check(gov.Steps() <= 10, "threshold: restores back off, at most 10 steps a minute");
+    return failures;
+}
+
+// --- Clicks ---
+
+static float g_arena[96 * 1024];
+
+static float MaxSecondDiff(const std::vector<float>& y, size_t from, size_t to) {
+    float m = 0.0f;
+    for (size_t i = from < 2 ? 2 : from; i < to && i < y.size(); i++)
+        m = std::fmax(m, std::fabs(y[i] - 2.0f * y[i - 1] + y[i - 2]));
+    return m;
+}
+
+static int Clicks() {
+    static constexpr float CLICK_RATIO = 2.0f;
+    static constexpr int   STEP_BLOCKS = 150;      // 150 ms per level
+    static constexpr int   WINDOW      = 960;      // 20 ms after each transition
+    std::printf("clicks\n");
+
+    static SynthEngine engine;
+    Arena arena;
+    arena.Init(g_arena, sizeof(g_arena) / sizeof(g_arena[0]));
+    if (!engine.Init(SR, arena)) {
+        std::printf("  arena too small\n");
+        return 1;
+    }
+    const int ccs[][2] = {{CC_CUTOFF, 50}, {CC_RES, 70}, {CC_FX, 40}, {CC_CAB, 127},
+                          {CC_FX_MIX, 127}, {CC_AMP_ENV, 0}};
+    for (const auto& cc : ccs) engine.ControlChange(cc[0], cc[1]);
+    const int chord[4] = {45, 52, 57, 64};
+    for (int n : chord) engine.NoteOn(n, 100);
+
+    const int levels[] = {0, 1, 2, 3, 4, 3, 2, 1, 0};
+    const int num_levels = sizeof(levels) / sizeof(levels[0]);
+    int settle_blocks = 2 * STEP_BLOCKS;   // reverb and envelopes come up first
+    std::vector<float> y;
+    std::vector<size_t> marks;
+    float buf[BLOCK];
+    for (int b = 0; b < settle_blocks + num_levels * STEP_BLOCKS; b++) {
+        int k = b - settle_blocks;
+        if (k >= 0 && k % STEP_BLOCKS == 0) {
+            engine.ApplyVoiceCap(levels[k / STEP_BLOCKS]);
+            engine.SetQuality(levels[k / STEP_BLOCKS]);
+            marks.push_back(y.size());
+        }
+        engine.Process(buf, BLOCK);
+        y.insert(y.end(), buf, buf + BLOCK);
+    }
+
+    // Steady state of level i: its segment minus the window after its start
+    // (the first one starts after the settle time)
+    size_t steady_from = static_cast<size_t>(STEP_BLOCKS) * BLOCK;
+    std::vector<float> steady;
+    steady.push_back(MaxSecondDiff(y, steady_from, marks[0]));
+    for (size_t i = 1; i < marks.size(); i++) {
+        size_t end = i + 1 < marks.size() ? marks[i + 1] : y.size();
+        steady.push_back(MaxSecondDiff(y, marks[i] + WINDOW, end));
+    }
+    float ref = steady[0];
+    int failures = 0;
+    std::printf("  steady-state max |d2| %.5f at full quality\n", ref);
+    for (size_t i = 1; i < marks.size(); i++) {
+        float d = MaxSecondDiff(y, marks[i] - 2, marks[i] + WINDOW);
+        float around = std::fmax(steady[i - 1], steady[i]);
+        char what[80];
+        std::snprintf(what, sizeof(what), "level %d -> %d: max |d2| %.5f (%.2fx steady)",
+                      levels[i - 1], levels[i], d, d / around);
+        failures += Check(d <= CLICK_RATIO * around, what);
+    }
+
+    // The measure must catch a real click: a hard 25% gain step
+    std::vector<float> clicked(y.begin() + steady_from, y.begin() + marks[0]);
+    size_t at = clicked.size() / 2;
+    for (size_t i = at; i < clicked.size(); i++) clicked[i] *= 0.75f;
+    float d = MaxSecondDiff(clicked, at - 2, at + WINDOW);
+    failures += Check(d > CLICK_RATIO * ref, "a hard 25% gain step is caught");
+    return failures;
+}
+
+int main() {
+    int failures = ControlLoop() + Clicks();
+    std::printf("%s\n", failures ? "FAILED" : "PASSED");
+    return failures ? 1 : 0;
+}
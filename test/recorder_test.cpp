@@ -0,0 +1,150 @@
+// test/recorder_test.cpp — Host test: streaming output recorder
+// Build:  make -C host recorder-test
+// Run:    host/build/recorder-test
+//
+// An "audio" thread pushes 48-sample blocks of a known signal into a
+// Recorder on a fixed schedule while the main thread services it into a
+// FileSink (host/file_sink.h). The run is RUN_S of audio paced at SPEEDUP
+// times real time. Checks, per scenario:
+//   file     — the WAV reads back, with the header sizes patched in
+//   content  — the file holds exactly the pushed samples, in order, less
+//              the dropped ones, and drops only ever cut a block's tail
+//   writes   — all but the last write are whole WRITE_BYTES pieces
+//   overruns — none when storage keeps up; counted, never blocking, when
+//              every write stalls longer than a half lasts
+// Also reports the file's write throughput against what the Seed needs.
+// Exits non-zero on failure.
+
+#include "recorder.h"
+#include "file_sink.h"
+#include "wav_file.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static constexpr int      SR      = 48000;
+static constexpr int      BLOCK   = 48;
+static constexpr double   RUN_S   = 6.0;
+static constexpr double   SPEEDUP = 10.0;
+
+using Rec = Recorder<FileSink>;
+
+static float Signal(uint64_t k) {
+    return static_cast<float>(static_cast<int>(k % 50000) - 25000) / 25000.0f;
+}
+
+static int16_t Converted(float x) {
+    x = std::max(-1.0f, std::min(1.0f, x));
+    return static_cast<int16_t>(x * 32767.0f);
+}
+
+static int Check(bool ok, const char* what) {
+    std::printf("  %-58s %s\n", what, ok ? "ok" : "FAIL");
+    return ok ? 0 : 1;
+}
+
+static int Scenario(const char* name, uint32_t write_delay_us, bool expect_overruns) {
+    static Rec rec;
+    FileSink sink;
+    sink.write_delay_us = write_delay_us;
+    std::string path = std::string("build/recorder_test_") + (expect_overruns ? "slow" : "ok") + ".wav";
+    if (!sink.Open(path) || !rec.Start(sink, SR)) {
+        std::printf("%s: can't open %s\n", name, path.c_str());
+        return 1;
+    }
+
+    // Audio thread: the samples that should land in the file
+    std::vector<int16_t> expected;
+    std::atomic<bool> pushed_all{false}, stop_called{false};
+    std::atomic<uint32_t> handovers{0};
+    int blocks = static_cast<int>(RUN_S * SR / BLOCK);
+    auto period = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(BLOCK / (SR * SPEEDUP)));
+
+    std::thread audio([&] {
+        float buf[BLOCK];
+        uint64_t k = 0;
+        Clock::time_point next = Clock::now();
+        for (int b = 0; b < blocks; b++) {
+            std::this_thread::sleep_until(next);
+            next += period;
+            for (int i = 0; i < BLOCK; i++) buf[i] = Signal(k + i);
+            uint32_t before = rec.DroppedSamples();
+            if (rec.Push(buf, BLOCK)) handovers++;
+            uint32_t dropped = rec.DroppedSamples() - before;
+            for (int i = 0; i < BLOCK - static_cast<int>(dropped); i++)
+                expected.push_back(Converted(buf[i]));
+            k += BLOCK;
+        }
+        pushed_all = true;
+        while (!stop_called) std::this_thread::yield();
+        rec.Push(buf, 0);   // the next callback sees the stop
+    });
+
+    // Main loop
+    Clock::time_point t0 = Clock::now();
+    double write_s = 0.0;
+    uint32_t written_before = 0;
+    while (rec.Recording()) {
+        if (pushed_all && !stop_called) {
+            rec.Stop();
+            stop_called = true;
+        }
+        Clock::time_point w0 = Clock::now();
+        bool more = rec.Service();
+        if (rec.DataBytes() != written_before) {
+            write_s += std::chrono::duration<double>(Clock::now() - w0).count();
+            written_before = rec.DataBytes();
+        }
+        if (!more) std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    audio.join();
+    double wall_s = std::chrono::duration<double>(Clock::now() - t0).count();
+
+    std::vector<float> samples;
+    int rate = 0;
+    bool read = ReadWav(path, samples, rate);
+    uint32_t whole = (rec.DataBytes() + Rec::WRITE_BYTES - 1) / Rec::WRITE_BYTES;
+    double mbps = rec.DataBytes() / 1e6 / (write_s > 0 ? write_s : 1e-9);
+
+    std::printf("%s: %zu samples in %.2f s, %u overruns, %u dropped, %u writes, "
+                "%.1f MB/s while writing (the Seed needs %.3f)\n",
+                name, samples.size(), wall_s, rec.Overruns(), rec.DroppedSamples(),
+                sink.Writes(), mbps, SR * 2 / 1e6);
+
+    int failures = 0;
+    failures += Check(read && rate == SR && samples.size() * 2 == rec.DataBytes(),
+                      "file: reads back, header sizes patched");
+    bool same = samples.size() == expected.size();
+    for (size_t i = 0; same && i < samples.size(); i++)
+        same = std::lrint(samples[i] * 32767.0f) == expected[i];
+    failures += Check(same, "content: pushed samples less the dropped ones, in order");
+    failures += Check(expected.size() + rec.DroppedSamples() == static_cast<size_t>(blocks) * BLOCK,
+                      "content: every sample written or counted as dropped");
+    // the header, then whole pieces, then the tail
+    failures += Check(sink.Writes() == 1 + whole && handovers > 0 && rec.WriteErrors() == 0,
+                      "writes: whole WRITE_BYTES pieces after the header");
+    if (expect_overruns)
+        failures += Check(rec.Overruns() > 0 && rec.DroppedSamples() > 0,
+                          "overruns: a stalled card drops blocks, counted");
+    else
+        failures += Check(rec.Overruns() == 0 && rec.DroppedSamples() == 0,
+                          "overruns: none while storage keeps up");
+    return failures;
+}
+
+int main() {
+    int failures = 0;
+    // A half lasts HALF_SAMPLES / (SR × SPEEDUP) ≈ 34 ms here. Each half is
+    // HALF_BYTES / WRITE_BYTES writes, so a 12 ms stall per write makes the
+    // card take ~48 ms a half and fall behind.
+    failures += Scenario("plain file", 0, false);
+    failures += Scenario("stalling card", 12000, true);
+    std::printf("%s\n", failures ? "FAILED" : "PASSED");
+    return failures ? 1 : 0;
+}